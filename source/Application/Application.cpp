@@ -5,14 +5,17 @@
 #include <SFML/Window/WindowStyle.hpp>
 #include <SFML/System/Clock.hpp>
 
+#include <thread>
+
 #include <imgui-SFML.h>
 #include <imgui.h>
 
 #include "Application.hpp"
+#include "Simulation.hpp"
+#include "FramePacer.hpp"
 #include "Entity/Entity.hpp"
 
 #include "Systems/RenderSystem.hpp"
-#include "Systems/MovementSystem.hpp"
 
 #include "Components/TransformableComponent.hpp"
 #include "Components/RenderableComponent.hpp"
@@ -26,15 +29,26 @@
 #include "ResourceManagement/ResourceContainers.hpp"
 #include "ResourceManagement/ResourceHandle.hpp"
 #include "Systems/SystemManager.hpp"
+#include "Threading/JobSystem.hpp"
+#include "Threading/TripleBuffer.hpp"
+#include "Systems/RenderSnapshot.hpp"
+#include "Helpers/TraceZones.hpp"
 
 const sf::Time Application::timePerFrame = sf::seconds(1.0f / 60.0f);
+const sf::Time Application::timePerRender = sf::seconds(1.0f / 60.0f);
+const bool Application::threadedSimulation = true;
 
 Application::Application()
     : window(sf::VideoMode(1920, 1080), "Testing Grounds", sf::Style::Close)
     , resourceCache(std::make_unique<ResourceCache>(10, new ZipResourceContainer("Assets.zip"))) // Cache will take ownership
+    , jobSystem(std::make_unique<JobSystem>())
     , eventManager(std::make_unique<EventManager>())
     , entityManager(std::make_unique<EntityManager>(*eventManager))
-    , systemManager(std::make_unique<SystemManager>(*entityManager, *eventManager))
+    , systemManager(std::make_unique<SystemManager>(*entityManager, *eventManager, jobSystem.get()))
+    , renderSnapshots(std::make_unique<TripleBuffer<RenderSnapshot>>())
+    , renderPacer(std::make_unique<FramePacer>(timePerRender))
+    , simulationPacer(std::make_unique<FramePacer>(timePerFrame))
+    , targetRenderRate(static_cast<int>(1.0f / timePerRender.asSeconds() + 0.5f))
 {
     // Initialize the resource cache
     if (!resourceCache->Initialize())
@@ -104,33 +118,97 @@ Application::~Application()
 
 void Application::runApplication()
 {
+    if (!threadedSimulation)
+    {
+        runSingleThreaded();
+        return;
+    }
+
+    // The window and ImGui stay on this thread, SFML wants the window's events polled on the thread that created it.
+    // From here on the EntityManager, EventManager and SystemManager belong to the simulation thread.
+    TraceZones::setThreadName("Render");
+    simulationRunning = true;
+    std::thread simulation(&Application::runSimulation, this);
+
     sf::Clock clock;
-    sf::Time timeSinceLastUpdate = sf::Time::Zero;
+    while (window.isOpen())
+    {
+        processSFMLEvents();
 
+        if (!window.isOpen())
+        {
+            break;
+        }
+
+        // Draws the newest tick, or the last one again if the simulation hasn't finished another, the GUI stays
+        // responsive and the pacer keeps it from burning the GPU
+        renderSnapshots->acquire();
+        renderFrame(renderSnapshots->readBuffer(), clock.restart());
+
+        renderPacer->waitForNextFrame();
+    }
+
+    simulationRunning = false;
+    simulation.join();
+}
+
+void Application::runSingleThreaded()
+{
+    TraceZones::setThreadName("Main");
+
+    sf::Clock clock;
     while (window.isOpen())
     {
-        //ImGui::NewFrame();
+        processSFMLEvents();
+
+        for (std::size_t steps = renderPacer->stepsDue(timePerFrame); steps > 0; --steps)
+        {
+            updateFrame(timePerFrame);
+        }
+
+        publishSnapshot();
+        renderSnapshots->acquire();
+        renderFrame(renderSnapshots->readBuffer(), clock.restart());
+
+        eventManager->dispatchQueued(EventPhase::PostRender);
+
+        renderPacer->waitForNextFrame();
+    }
+}
 
-        const sf::Time deltaTime = clock.restart();
-        timeSinceLastUpdate += deltaTime;
+void Application::runSimulation()
+{
+    TraceZones::setThreadName("Simulation");
+
+    // This thread starts and waits on the system jobs, it should be the one helping out while waiting
+    jobSystem->adoptCallingThread();
 
-        while (timeSinceLastUpdate >= timePerFrame)
+    while (simulationRunning)
+    {
+        // After a stall the simulation falls behind real time instead of trying to catch up all of it at once
+        const std::size_t steps = simulationPacer->stepsDue(timePerFrame);
+        for (std::size_t i = 0; i < steps; ++i)
         {
-            //ImGui::EndFrame();
-            processSFMLEvents();
             updateFrame(timePerFrame);
+        }
 
-            timeSinceLastUpdate -= timePerFrame;
+        if (steps > 0)
+        {
+            publishSnapshot();
+
+            // NOTE: The frame is handed over but most likely not on screen yet, nothing on this side can wait for the
+            // draw without giving up the overlap. Listeners only rely on the frame's updates being done.
+            eventManager->dispatchQueued(EventPhase::PostRender);
         }
 
-        renderFrame(timePerFrame);
+        simulationPacer->waitForNextFrame();
     }
 }
 
 void Application::setupSystems()
 {
     systemManager->addSystem<RenderSystem>(window);
-    systemManager->addSystem<MovementSystem>();
+    addSimulationSystems(*systemManager);
 
     systemManager->configure();
 }
@@ -161,14 +239,26 @@ void Application::processSFMLEvents()
 
 void Application::updateFrame(const sf::Time& deltaTime)
 {
-    systemManager->updateAllSystems(deltaTime);
+    stepSimulation(*eventManager, *systemManager, deltaTime);
+}
+
+void Application::publishSnapshot()
+{
+    TRACE_SCOPE("Application::publishSnapshot");
+
+    RenderSnapshot& snapshot = renderSnapshots->writeBuffer();
+    systemManager->getSystem<RenderSystem>()->capture(*entityManager, snapshot);
+    snapshot.tick = ++simulationTick;
+
+    renderSnapshots->publish();
 }
 
-void Application::renderFrame(const sf::Time& deltaTime)
+void Application::renderFrame(const RenderSnapshot& snapshot, const sf::Time& deltaTime)
 {
-    // TODO: GUI isn't working, has to deal with updating and rendering being separated and running at different timesteps.
-    // Might just move all GUI updating and rending to live strictly on the rendering side, though this is cheap fix and will cause problems
-    // if we multi-thread in the future.
+    TRACE_SCOPE("Application::renderFrame");
+
+    // The GUI lives strictly on the render side, anything it shows from the simulation has to be safe to read from here
+    // (the profiler locks, the snapshot is ours until the next acquire()).
     ImGui::SFML::Update(window, deltaTime);
 
     // TODO: Remove all this is just testing code
@@ -181,8 +271,41 @@ void Application::renderFrame(const sf::Time& deltaTime)
     }
     ImGui::End(); // end window
 
+    drawSystemProfiler(systemManager->getProfiler());
+    drawFramePacing();
+
     window.clear(bgColor);
-    systemManager->getSystem<RenderSystem>()->render(*entityManager);
+    {
+        auto scope = systemManager->profileRender<RenderSystem>();
+        systemManager->getSystem<RenderSystem>()->render(snapshot);
+    }
+
     ImGui::SFML::Render(window);
     window.display();
+}
+
+void Application::drawFramePacing()
+{
+    ImGui::Begin("Frame Pacing");
+
+    if (ImGui::SliderInt("Target render rate", &targetRenderRate, 15, 240))
+    {
+        renderPacer->setTargetFrameTime(sf::seconds(1.0f / static_cast<float>(targetRenderRate)));
+    }
+
+    const auto drawStats = [](const char* label, const FramePacer::Stats& stats)
+    {
+        ImGui::Separator();
+        ImGui::Text("%s (target %.2f ms)", label, stats.targetMs);
+        ImGui::Text("avg %.2f  p50 %.2f  p95 %.2f  p99 %.2f  max %.2f ms", stats.avgMs, stats.p50Ms, stats.p95Ms, stats.p99Ms, stats.maxMs);
+        ImGui::Text("Stutters: %zu  Dropped steps: %zu", stats.stutters, stats.droppedSteps);
+    };
+
+    drawStats("Render", renderPacer->stats());
+    if (threadedSimulation)
+    {
+        drawStats("Simulation", simulationPacer->stats());
+    }
+
+    ImGui::End();
 }
\ No newline at end of file
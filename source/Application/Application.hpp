@@ -1,6 +1,8 @@
 #pragma once
 
 #include <memory>
+#include <atomic>
+#include <cstdint>
 #include <SFML/System/NonCopyable.hpp>
 #include <SFML/Graphics/RenderWindow.hpp>
 
@@ -8,6 +10,10 @@ class ResourceCache;
 class EventManager;
 class EntityManager;
 class SystemManager;
+class JobSystem;
+class FramePacer;
+struct RenderSnapshot;
+template <typename T> class TripleBuffer;
 
 class Application : private sf::NonCopyable
 {
@@ -25,12 +31,22 @@ class Application : private sf::NonCopyable
 
         void setupSystems();
         
+        void runSingleThreaded();
+        void runSimulation();
+
         void processSFMLEvents();
         void updateFrame(const sf::Time& deltaTime);
-        void renderFrame(const sf::Time& deltaTime);
+        void publishSnapshot();
+        void renderFrame(const RenderSnapshot& snapshot, const sf::Time& deltaTime);
+        void drawFramePacing();
 
     private:
         static const sf::Time timePerFrame;
+        static const sf::Time timePerRender; // Starting target of the render pacer, the pacing window can change it
+
+        // Runs the fixed step updates on their own thread while this one draws the last finished tick.
+        // Turn it off to get everything back on the main thread when debugging.
+        static const bool threadedSimulation;
 
         sf::RenderWindow window;
 
@@ -39,10 +55,21 @@ class Application : private sf::NonCopyable
         sf::Color bgColor;
 
         std::unique_ptr<ResourceCache> resourceCache;
+        std::unique_ptr<JobSystem> jobSystem; // Engine wide worker threads, the thread running the simulation joins in while waiting
 
         // Do not change the ordering of these
         // will mess up the constructor if you do.
         std::unique_ptr<EventManager> eventManager;
         std::unique_ptr<EntityManager> entityManager;
         std::unique_ptr<SystemManager> systemManager;
+
+        // Filled by the simulation, drawn by the thread owning the window
+        std::unique_ptr<TripleBuffer<RenderSnapshot>> renderSnapshots;
+        std::atomic<bool> simulationRunning{ false };
+        std::uint64_t simulationTick = 0;
+
+        // Keep the loops at their rates without spinning, the render one also paces the single threaded loop
+        std::unique_ptr<FramePacer> renderPacer;
+        std::unique_ptr<FramePacer> simulationPacer;
+        int targetRenderRate;
 };
\ No newline at end of file
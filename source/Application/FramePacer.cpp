@@ -0,0 +1,135 @@
+#include "FramePacer.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <SFML/System/Sleep.hpp>
+
+FramePacer::FramePacer(sf::Time targetFrameTime, std::size_t maxCatchUpSteps, std::size_t historySize)
+    : targetFrameTime(toDuration(targetFrameTime))
+    , maxCatchUpSteps(maxCatchUpSteps > 0 ? maxCatchUpSteps : 1)
+    , lastFrame(Clock::now())
+    , nextFrame(lastFrame + this->targetFrameTime)
+    , lastStep(lastFrame)
+    , history(historySize > 0 ? historySize : 1, 0.0f)
+{}
+
+void FramePacer::setTargetFrameTime(sf::Time frameTime)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    targetFrameTime = toDuration(frameTime);
+    nextFrame = lastFrame + targetFrameTime;
+}
+
+sf::Time FramePacer::getTargetFrameTime() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    return sf::microseconds(std::chrono::duration_cast<std::chrono::microseconds>(targetFrameTime).count());
+}
+
+std::size_t FramePacer::stepsDue(sf::Time stepTime)
+{
+    const Clock::duration step = toDuration(stepTime);
+    if (step <= Clock::duration::zero())
+    {
+        return 0;
+    }
+
+    const Clock::time_point now = Clock::now();
+    stepAccumulator += now - lastStep;
+    lastStep = now;
+
+    std::size_t steps = static_cast<std::size_t>(stepAccumulator / step);
+    stepAccumulator -= step * static_cast<Clock::rep>(steps);
+
+    if (steps > maxCatchUpSteps)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        droppedSteps += steps - maxCatchUpSteps;
+        steps = maxCatchUpSteps;
+    }
+
+    return steps;
+}
+
+void FramePacer::waitForNextFrame()
+{
+    Clock::duration target;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        target = targetFrameTime;
+    }
+
+    const Clock::duration remaining = nextFrame - Clock::now();
+    if (remaining > spinThreshold)
+    {
+        sf::sleep(sf::microseconds(std::chrono::duration_cast<std::chrono::microseconds>(remaining - spinThreshold).count()));
+    }
+
+    while (Clock::now() < nextFrame)
+    {
+        std::this_thread::yield();
+    }
+
+    const Clock::time_point now = Clock::now();
+    record(now - lastFrame);
+    lastFrame = now;
+
+    // Stay on the cadence, unless a whole frame got missed, then start over from here
+    nextFrame += target;
+    if (nextFrame < now)
+    {
+        nextFrame = now + target;
+    }
+}
+
+FramePacer::Stats FramePacer::stats() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    Stats result = {};
+    result.targetMs = std::chrono::duration<double, std::milli>(targetFrameTime).count();
+    result.stutters = stutters;
+    result.droppedSteps = droppedSteps;
+    result.frames = historyCount;
+    if (historyCount == 0)
+    {
+        return result;
+    }
+
+    std::vector<float> samples(history.begin(), history.begin() + historyCount);
+
+    double total = 0.0;
+    for (float sample : samples)
+    {
+        total += sample;
+    }
+
+    result.avgMs = total / static_cast<double>(samples.size());
+
+    // Nearest rank, same as SystemProfiler
+    std::sort(samples.begin(), samples.end());
+    const auto percentile = [&samples](std::size_t p) { return samples[(samples.size() * p + 99) / 100 - 1]; };
+    result.p50Ms = percentile(50);
+    result.p95Ms = percentile(95);
+    result.p99Ms = percentile(99);
+    result.maxMs = samples.back();
+
+    return result;
+}
+
+void FramePacer::record(Clock::duration frameTime)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    const float milliseconds = std::chrono::duration<float, std::milli>(frameTime).count();
+    history[historyNext] = milliseconds;
+    historyNext = (historyNext + 1) % history.size();
+    historyCount = std::min(historyCount + 1, history.size());
+
+    if (frameTime * 2 > targetFrameTime * 3)
+    {
+        ++stutters;
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <SFML/System/Time.hpp>
+
+// Keeps a loop at a target rate without burning a core. waitForNextFrame() sleeps most of
+// the way to the next frame and spins (yielding) through the last spinThreshold, OS sleeps
+// tend to oversleep by a millisecond or so. Frames are scheduled on a fixed cadence, a late
+// frame makes the next wait shorter instead of pushing every following frame back.
+//
+//      while (running)
+//      {
+//          for (std::size_t steps = pacer.stepsDue(timePerStep); steps > 0; --steps)
+//          {
+//              update(timePerStep);
+//          }
+//
+//          render();
+//          pacer.waitForNextFrame();
+//      }
+//
+// NOTE: Everything but stats() is for the thread running the loop.
+class FramePacer
+{
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        struct Stats
+        {
+            std::size_t frames;       // In the history, at most historySize
+            double targetMs;
+            double avgMs;
+            double p50Ms;
+            double p95Ms;
+            double p99Ms;
+            double maxMs;
+            std::size_t stutters;     // Frames that took over 1.5 times the target, since the start
+            std::size_t droppedSteps; // Steps stepsDue() gave up on to avoid a spiral of death, since the start
+        };
+
+        explicit FramePacer(sf::Time targetFrameTime, std::size_t maxCatchUpSteps = 5, std::size_t historySize = 600);
+
+        void setTargetFrameTime(sf::Time frameTime);
+        sf::Time getTargetFrameTime() const;
+
+        void setSpinThreshold(sf::Time threshold) { spinThreshold = toDuration(threshold); }
+
+        // Real time since the last call in whole fixed steps, the remainder carries over. After a
+        // stall only maxCatchUpSteps are returned and the rest is dropped, otherwise catching up
+        // makes the next frame even longer and the simulation never recovers.
+        std::size_t stepsDue(sf::Time stepTime);
+
+        // Returns once the next frame is due and records how long this one took
+        void waitForNextFrame();
+
+        Stats stats() const;
+
+    private:
+        static Clock::duration toDuration(sf::Time time) { return std::chrono::duration_cast<Clock::duration>(std::chrono::microseconds(time.asMicroseconds())); }
+
+        void record(Clock::duration frameTime);
+
+    private:
+        Clock::duration targetFrameTime;
+        Clock::duration spinThreshold = std::chrono::milliseconds(2);
+        std::size_t maxCatchUpSteps;
+
+        Clock::time_point lastFrame;
+        Clock::time_point nextFrame;
+
+        Clock::time_point lastStep;
+        Clock::duration stepAccumulator = Clock::duration::zero();
+
+        mutable std::mutex lock; // Guards everything below, stats() is read by other threads
+        std::vector<float> history; // Frame times in ms, ring buffer
+        std::size_t historyNext = 0;
+        std::size_t historyCount = 0;
+        std::size_t stutters = 0;
+        std::size_t droppedSteps = 0;
+};
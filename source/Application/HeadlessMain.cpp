@@ -0,0 +1,60 @@
+// Entry point of the headless executable, build with -DBUILD_HEADLESS=ON.
+//
+//      HeadlessSimulation [ticks] [agents] [workers]
+//
+// Spawns a synthetic steering workload, runs it for the given number of ticks as fast as
+// possible and prints the ticks/sec.
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "HeadlessRunner.hpp"
+#include "Entity/EntityManager.hpp"
+#include "Components/TransformableComponent.hpp"
+#include "Components/MovementComponent.hpp"
+#include "Components/SteeringComponent.hpp"
+
+namespace
+{
+    std::size_t argument(int argc, char** argv, int index, std::size_t fallback)
+    {
+        return index < argc ? static_cast<std::size_t>(std::strtoull(argv[index], nullptr, 10)) : fallback;
+    }
+
+    // Every agent wanders off with a constant velocity, a quarter of them steer towards a target
+    void spawnAgents(EntityManager& entityManager, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            Entity entity = entityManager.createEntity();
+            const sf::Vector2f position(static_cast<float>(i % 1000), static_cast<float>(i / 1000));
+
+            entityManager.assignComponent<TransformableComponent>(entity.id(), position);
+            ComponentPtr<MovementComponent> movement = entityManager.assignComponent<MovementComponent>(entity.id(), 1.0f, 50.0f, 10.0f, 10.0f);
+            movement->velocity = sf::Vector2f(1.0f, 0.5f);
+
+            if (i % 4 == 0)
+            {
+                ComponentPtr<SteeringComponent> steering = entityManager.assignComponent<SteeringComponent>(entity.id());
+                steering->behaviorFlags = BehaviorType::Arrive;
+                steering->arrivePosition = sf::Vector2f(500.0f, 500.0f);
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::size_t ticks = argument(argc, argv, 1, 6000);
+    const std::size_t agents = argument(argc, argv, 2, 10000);
+    const std::size_t workers = argument(argc, argv, 3, JobSystem::defaultWorkerCount());
+
+    HeadlessRunner runner(workers);
+    spawnAgents(runner.getEntityManager(), agents);
+    runner.setupSystems();
+
+    std::cout << agents << " agents, " << workers << " workers\n";
+    HeadlessRunner::writeReport(std::cout, runner.run(ticks));
+
+    return 0;
+}
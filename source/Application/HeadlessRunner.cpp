@@ -0,0 +1,85 @@
+#include "HeadlessRunner.hpp"
+#include "Simulation.hpp"
+
+#include <chrono>
+#include <limits>
+#include <algorithm>
+#include <ostream>
+
+#include "EventManagement/EventManager.hpp"
+#include "Entity/EntityManager.hpp"
+#include "Systems/SystemManager.hpp"
+
+HeadlessRunner::HeadlessRunner(std::size_t workerCount, sf::Time timePerTick)
+    : timePerTick(timePerTick)
+    , jobSystem(std::make_unique<JobSystem>(workerCount))
+    , eventManager(std::make_unique<EventManager>())
+    , entityManager(std::make_unique<EntityManager>(*eventManager))
+    , systemManager(std::make_unique<SystemManager>(*entityManager, *eventManager, jobSystem.get()))
+{}
+
+HeadlessRunner::~HeadlessRunner() = default;
+
+void HeadlessRunner::setupSystems()
+{
+    addSimulationSystems(*systemManager);
+    systemManager->configure();
+}
+
+void HeadlessRunner::step()
+{
+    stepSimulation(*eventManager, *systemManager, timePerTick);
+    eventManager->dispatchQueued(EventPhase::PostRender);
+}
+
+HeadlessRunner::Report HeadlessRunner::run(std::uint64_t tickCount)
+{
+    return runTicks(tickCount, sf::Time::Zero);
+}
+
+HeadlessRunner::Report HeadlessRunner::runUntilStopped(sf::Time maxWallTime)
+{
+    return runTicks(std::numeric_limits<std::uint64_t>::max(), maxWallTime);
+}
+
+void HeadlessRunner::writeReport(std::ostream& output, const Report& report)
+{
+    output << report.ticks << " ticks (" << report.simulatedTime.asSeconds() << "s simulated) in "
+           << report.wallSeconds << "s, " << report.ticksPerSecond << " ticks/s, slowest tick "
+           << report.slowestTickMs << " ms\n";
+}
+
+HeadlessRunner::Report HeadlessRunner::runTicks(std::uint64_t tickCount, sf::Time maxWallTime)
+{
+    using Clock = std::chrono::steady_clock;
+
+    stopRequested = false;
+
+    const Clock::time_point start = Clock::now();
+    const Clock::time_point deadline = start + std::chrono::microseconds(maxWallTime.asMicroseconds());
+    Clock::duration slowest = Clock::duration::zero();
+
+    std::uint64_t ticks = 0;
+    while (ticks < tickCount && !stopRequested)
+    {
+        const Clock::time_point tickStart = Clock::now();
+        step();
+        ++ticks;
+
+        const Clock::time_point tickEnd = Clock::now();
+        slowest = std::max(slowest, tickEnd - tickStart);
+        if (maxWallTime > sf::Time::Zero && tickEnd >= deadline)
+        {
+            break;
+        }
+    }
+
+    Report report;
+    report.ticks = ticks;
+    report.simulatedTime = sf::microseconds(timePerTick.asMicroseconds() * static_cast<std::int64_t>(ticks));
+    report.wallSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    report.ticksPerSecond = report.wallSeconds > 0.0 ? static_cast<double>(ticks) / report.wallSeconds : 0.0;
+    report.slowestTickMs = std::chrono::duration<double, std::milli>(slowest).count();
+
+    return report;
+}
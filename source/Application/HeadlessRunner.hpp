@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <atomic>
+#include <iosfwd>
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Time.hpp>
+
+#include "Threading/JobSystem.hpp"
+
+class EventManager;
+class EntityManager;
+class SystemManager;
+
+// Runs the simulation without a window, ImGui or RenderSystem, for servers, batch runs and
+// performance regression runs. Ticks are stepped back to back as fast as they go with the
+// same fixed timestep Application uses, nothing waits for the wall clock.
+//
+//      HeadlessRunner runner;
+//      spawnAgents(runner.getEntityManager());
+//      runner.setupSystems();
+//      HeadlessRunner::Report report = runner.run(6000);
+//      HeadlessRunner::writeReport(std::cout, report);
+class HeadlessRunner : private sf::NonCopyable
+{
+    public:
+        struct Report
+        {
+            std::uint64_t ticks;
+            sf::Time simulatedTime;
+            double wallSeconds;
+            double ticksPerSecond;
+            double slowestTickMs;
+        };
+
+        // workerCount threads help the calling thread update systems (MovementSystem splits its entity
+        // loop over them), 0 updates everything on the calling thread
+        explicit HeadlessRunner(std::size_t workerCount = JobSystem::defaultWorkerCount(), sf::Time timePerTick = sf::seconds(1.0f / 60.0f));
+        ~HeadlessRunner();
+
+        // Adds the simulation systems (see addSimulationSystems()) and configures them. Add any
+        // extra systems before calling it.
+        void setupSystems();
+
+        // One fixed timestep, PostRender events included since no frame gets drawn
+        void step();
+
+        Report run(std::uint64_t tickCount);
+
+        // Until stop() is called, from a system or another thread, or maxWallTime has passed (Zero means no limit)
+        Report runUntilStopped(sf::Time maxWallTime = sf::Time::Zero);
+        void stop() { stopRequested = true; }
+
+        static void writeReport(std::ostream& output, const Report& report);
+
+        JobSystem& getJobSystem() { return *jobSystem; }
+        EventManager& getEventManager() { return *eventManager; }
+        EntityManager& getEntityManager() { return *entityManager; }
+        SystemManager& getSystemManager() { return *systemManager; }
+        const sf::Time& getTimePerTick() const { return timePerTick; }
+
+    private:
+        Report runTicks(std::uint64_t tickCount, sf::Time maxWallTime);
+
+    private:
+        sf::Time timePerTick;
+        std::atomic<bool> stopRequested{ false };
+
+        // Same order as Application, the managers are built on top of each other
+        std::unique_ptr<JobSystem> jobSystem;
+        std::unique_ptr<EventManager> eventManager;
+        std::unique_ptr<EntityManager> entityManager;
+        std::unique_ptr<SystemManager> systemManager;
+};
@@ -0,0 +1,27 @@
+#include "Simulation.hpp"
+
+#include "EventManagement/EventManager.hpp"
+#include "Systems/SystemManager.hpp"
+#include "Systems/MovementSystem.hpp"
+#include "Helpers/TraceZones.hpp"
+#include "Helpers/FrameArena.hpp"
+
+void addSimulationSystems(SystemManager& systemManager)
+{
+    systemManager.addSystem<MovementSystem>();
+}
+
+void stepSimulation(EventManager& eventManager, SystemManager& systemManager, const sf::Time& deltaTime)
+{
+    TRACE_SCOPE("Simulation::step");
+
+    // Scratch memory of the last step is done with
+    FrameArena::beginFrame();
+
+    // Results sent by other threads since the last frame
+    eventManager.drainChannels();
+
+    eventManager.dispatchQueued(EventPhase::PreUpdate);
+    systemManager.updateAllSystems(deltaTime);
+    eventManager.dispatchQueued(EventPhase::PostUpdate);
+}
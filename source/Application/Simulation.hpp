@@ -0,0 +1,16 @@
+#pragma once
+
+#include <SFML/System/Time.hpp>
+
+class EventManager;
+class SystemManager;
+
+// The parts of a frame that don't need a window, shared by Application and HeadlessRunner
+// so both simulate exactly the same way.
+
+// Adds every system the simulation runs, which is everything but RenderSystem. Doesn't
+// call SystemManager::configure().
+void addSimulationSystems(SystemManager& systemManager);
+
+// One fixed timestep: a new FrameArena frame, channel results, PreUpdate events, the systems, PostUpdate events
+void stepSimulation(EventManager& eventManager, SystemManager& systemManager, const sf::Time& deltaTime);
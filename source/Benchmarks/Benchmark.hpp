@@ -0,0 +1,48 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+// Tiny timing helpers for the benchmark executable (BUILD_BENCHMARKS), not meant for engine code.
+namespace Benchmark
+{
+    using Clock = std::chrono::steady_clock;
+
+    inline double elapsedNanoseconds(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }
+
+    // Runs func iterations times and returns the average nanoseconds per call.
+    template <typename Func>
+    double measure(std::size_t iterations, Func&& func)
+    {
+        const Clock::time_point start = Clock::now();
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            func();
+        }
+
+        return elapsedNanoseconds(start) / static_cast<double>(iterations);
+    }
+
+    inline const void* volatile keepSink = nullptr;
+
+    // Stops the optimizer from throwing away a result that is otherwise unused.
+    template <typename T>
+    void keep(const T& value)
+    {
+        keepSink = &value;
+    }
+
+    inline void section(const char* name)
+    {
+        std::printf("\n== %s\n", name);
+    }
+
+    inline void report(const char* name, double nanoseconds)
+    {
+        std::printf("  %-48s %12.1f ns\n", name, nanoseconds);
+    }
+}
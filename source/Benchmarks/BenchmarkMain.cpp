@@ -0,0 +1,15 @@
+// Entry point of the benchmark executable, build with -DBUILD_BENCHMARKS=ON.
+void runStateDeltaBenchmarks();
+void runEventBenchmarks();
+void runSimulationBenchmarks();
+void runFrameArenaBenchmarks();
+
+int main()
+{
+    runStateDeltaBenchmarks();
+    runEventBenchmarks();
+    runSimulationBenchmarks();
+    runFrameArenaBenchmarks();
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,378 @@
+#include <cstdio>
+#include <cassert>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "Entity/EntityManager.hpp"
+#include "EventManagement/EventManager.hpp"
+#include "EventManagement/Events/EntityEvents.hpp"
+#include "EventManagement/Events/ComponentEvents.hpp"
+#include "EventManagement/SimpleSignal.hpp"
+#include "EventManagement/StaticEventBus.hpp"
+#include "Components/TransformableComponent.hpp"
+
+namespace
+{
+    struct BenchEvent : public Event<BenchEvent>
+    {
+        explicit BenchEvent(int value) : value(value) {}
+
+        int value;
+    };
+
+    struct OtherEvent : public Event<OtherEvent>
+    {
+        int value = 0;
+    };
+
+    struct CountingReceiver : public Receiver<CountingReceiver>
+    {
+        void receive(const BenchEvent& event) { sum += event.value; }
+        void receive(const OtherEvent& event) { sum += event.value; }
+        void receive(const EntityCreatedEvent&) { ++sum; }
+        void receive(const ComponentAddedEvent<TransformableComponent>&) { ++sum; }
+
+        long sum = 0;
+    };
+
+    struct BatchReceiver : public Receiver<BatchReceiver>
+    {
+        void receive(std::span<const BenchEvent> events)
+        {
+            for (const BenchEvent& event : events)
+            {
+                sum += event.value;
+            }
+        }
+
+        long sum = 0;
+    };
+
+    struct PlainReceiver
+    {
+        void receive(const BenchEvent& event) { sum += event.value; }
+
+        long sum = 0;
+    };
+
+    struct PingEvent : public Event<PingEvent>
+    {
+        explicit PingEvent(const Entity& entity) : entity(entity) {}
+
+        Entity entity;
+    };
+
+    struct EntityWatcher : public Receiver<EntityWatcher>
+    {
+        void receive(const PingEvent&) { ++pings; }
+        void receive(const EntityDestroyedEvent&) { ++destroyed; }
+
+        std::size_t pings = 0;
+        std::size_t destroyed = 0;
+    };
+
+    const std::size_t ReceiverCounts[] = { 0, 1, 10, 100 };
+
+    std::vector<std::unique_ptr<CountingReceiver>> makeReceivers(std::size_t count)
+    {
+        std::vector<std::unique_ptr<CountingReceiver>> receivers;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            receivers.push_back(std::make_unique<CountingReceiver>());
+        }
+
+        return receivers;
+    }
+
+    // Roughly the same number of receive() calls for every receiver count
+    std::size_t emitIterations(std::size_t receiverCount)
+    {
+        return receiverCount > 1 ? 20000000 / receiverCount : 2000000;
+    }
+
+    void runSubscribeBenchmarks()
+    {
+        Benchmark::section("Subscribe / unsubscribe");
+
+        char name[64];
+        for (std::size_t existing : ReceiverCounts)
+        {
+            EventManager eventManager;
+            std::vector<std::unique_ptr<CountingReceiver>> receivers = makeReceivers(existing);
+            for (std::unique_ptr<CountingReceiver>& receiver : receivers)
+            {
+                eventManager.subscribe<BenchEvent>(*receiver);
+            }
+
+            CountingReceiver receiver;
+            std::snprintf(name, sizeof(name), "EventManager pair, %zu subscribed", existing);
+            Benchmark::report(name, Benchmark::measure(200000, [&]()
+            {
+                eventManager.subscribe<BenchEvent>(receiver);
+                eventManager.unsubscribe<BenchEvent>(receiver);
+            }));
+        }
+
+        for (std::size_t existing : ReceiverCounts)
+        {
+            Simple::Signal<void (const BenchEvent&)> signal;
+            long sum = 0;
+            for (std::size_t i = 0; i < existing; ++i)
+            {
+                signal.connect([&sum](const BenchEvent& event) { sum += event.value; });
+            }
+
+            std::snprintf(name, sizeof(name), "Simple::Signal pair, %zu connected", existing);
+            Benchmark::report(name, Benchmark::measure(200000, [&]()
+            {
+                const std::size_t connection = signal.connect([&sum](const BenchEvent& event) { sum += event.value; });
+                signal.disconnect(connection);
+            }));
+        }
+    }
+
+    void runEmitBenchmarks()
+    {
+        Benchmark::section("Emit, per event");
+
+        char name[64];
+        for (std::size_t count : ReceiverCounts)
+        {
+            EventManager eventManager;
+            std::vector<std::unique_ptr<CountingReceiver>> receivers = makeReceivers(count);
+            for (std::unique_ptr<CountingReceiver>& receiver : receivers)
+            {
+                eventManager.subscribe<BenchEvent>(*receiver);
+            }
+
+            const BenchEvent event(1);
+            std::snprintf(name, sizeof(name), "EventManager emit(event), %zu receivers", count);
+            Benchmark::report(name, Benchmark::measure(emitIterations(count), [&]() { eventManager.emit(event); }));
+
+            int value = 0;
+            std::snprintf(name, sizeof(name), "EventManager emit<T>(args), %zu receivers", count);
+            Benchmark::report(name, Benchmark::measure(emitIterations(count), [&]() { eventManager.emit<BenchEvent>(++value); }));
+
+            for (std::unique_ptr<CountingReceiver>& receiver : receivers)
+            {
+                Benchmark::keep(receiver->sum);
+            }
+        }
+
+        for (std::size_t count : ReceiverCounts)
+        {
+            Simple::Signal<void (const BenchEvent&)> signal;
+            std::vector<PlainReceiver> receivers(count);
+            for (PlainReceiver& receiver : receivers)
+            {
+                signal.connect(Simple::slot(receiver, &PlainReceiver::receive));
+            }
+
+            const BenchEvent event(1);
+            std::snprintf(name, sizeof(name), "Simple::Signal emit, %zu receivers", count);
+            Benchmark::report(name, Benchmark::measure(emitIterations(count), [&]() { signal.emit(event); }));
+        }
+
+        // Lower bound, what a direct call costs
+        std::unique_ptr<PlainReceiver> plain = std::make_unique<PlainReceiver>();
+        StaticEventBus<PlainReceiver> bus(*plain);
+        int value = 0;
+        Benchmark::report("StaticEventBus emit, 1 receiver", Benchmark::measure(emitIterations(1), [&]()
+        {
+            bus.emit<BenchEvent>(++value);
+            Benchmark::keep(plain->sum);
+        }));
+    }
+
+    void runReceiverDestructionBenchmarks()
+    {
+        Benchmark::section("BaseReceiver destruction");
+
+        const std::size_t iterations = 100000;
+        char name[64];
+        for (std::size_t count : ReceiverCounts)
+        {
+            if (count == 0)
+            {
+                continue;
+            }
+
+            EventManager eventManager;
+            std::vector<std::unique_ptr<CountingReceiver>> receivers = makeReceivers(count);
+            for (std::unique_ptr<CountingReceiver>& receiver : receivers)
+            {
+                eventManager.subscribe<BenchEvent>(*receiver);
+                eventManager.subscribe<OtherEvent>(*receiver);
+            }
+
+            // Always destroys the oldest receiver, the one at the front of the delegate arrays,
+            // and puts a fresh one at the back so the count stays the same
+            double nanoseconds = 0.0;
+            for (std::size_t i = 0; i < iterations; ++i)
+            {
+                std::unique_ptr<CountingReceiver>& oldest = receivers[i % count];
+
+                const Benchmark::Clock::time_point start = Benchmark::Clock::now();
+                oldest.reset();
+                nanoseconds += Benchmark::elapsedNanoseconds(start);
+
+                oldest = std::make_unique<CountingReceiver>();
+                eventManager.subscribe<BenchEvent>(*oldest);
+                eventManager.subscribe<OtherEvent>(*oldest);
+            }
+
+            std::snprintf(name, sizeof(name), "2 subscriptions, %zu receivers", count);
+            Benchmark::report(name, nanoseconds / static_cast<double>(iterations));
+        }
+    }
+
+    void runQueuedBenchmarks()
+    {
+        Benchmark::section("Immediate vs queued, per event");
+
+        const std::size_t eventsPerFrame = 10000;
+        const std::size_t frames = 100;
+        char name[64];
+
+        for (std::size_t count : ReceiverCounts)
+        {
+            EventManager eventManager;
+            std::vector<std::unique_ptr<CountingReceiver>> receivers = makeReceivers(count);
+            for (std::unique_ptr<CountingReceiver>& receiver : receivers)
+            {
+                eventManager.subscribe<BenchEvent>(*receiver);
+            }
+
+            auto runFrames = [&]()
+            {
+                const Benchmark::Clock::time_point start = Benchmark::Clock::now();
+                for (std::size_t frame = 0; frame < frames; ++frame)
+                {
+                    for (std::size_t i = 0; i < eventsPerFrame; ++i)
+                    {
+                        eventManager.emit<BenchEvent>(static_cast<int>(i));
+                    }
+
+                    eventManager.dispatchQueued(EventPhase::PostUpdate);
+                }
+
+                return Benchmark::elapsedNanoseconds(start) / static_cast<double>(frames * eventsPerFrame);
+            };
+
+            std::snprintf(name, sizeof(name), "immediate, %zu receivers", count);
+            Benchmark::report(name, runFrames());
+
+            eventManager.queueEvents<BenchEvent>(EventPhase::PostUpdate);
+            std::snprintf(name, sizeof(name), "queued, %zu receivers", count);
+            Benchmark::report(name, runFrames());
+
+            // Every receiver takes the whole frame at once instead
+            for (std::unique_ptr<CountingReceiver>& receiver : receivers)
+            {
+                eventManager.unsubscribe<BenchEvent>(*receiver);
+            }
+
+            std::vector<std::unique_ptr<BatchReceiver>> batchReceivers;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                batchReceivers.push_back(std::make_unique<BatchReceiver>());
+                eventManager.subscribeBatch<BenchEvent>(*batchReceivers.back());
+            }
+
+            std::snprintf(name, sizeof(name), "queued batch, %zu receivers", count);
+            Benchmark::report(name, runFrames());
+        }
+    }
+
+    // Every createEntity / assignComponent emits, so receivers of those events are part of the spawn cost
+    void runSpawnBenchmarks()
+    {
+        Benchmark::section("Spawn (createEntity + assignComponent), per entity");
+
+        const std::size_t entityCount = 100000;
+        char name[64];
+
+        for (std::size_t count : ReceiverCounts)
+        {
+            EventManager eventManager;
+            std::vector<std::unique_ptr<CountingReceiver>> receivers = makeReceivers(count);
+            for (std::unique_ptr<CountingReceiver>& receiver : receivers)
+            {
+                eventManager.subscribe<EntityCreatedEvent>(*receiver);
+                eventManager.subscribe<ComponentAddedEvent<TransformableComponent>>(*receiver);
+            }
+
+            EntityManager entityManager(eventManager);
+            const Benchmark::Clock::time_point start = Benchmark::Clock::now();
+            for (std::size_t i = 0; i < entityCount; ++i)
+            {
+                Entity entity = entityManager.createEntity();
+                entityManager.assignComponent<TransformableComponent>(entity.id(), sf::Vector2f(static_cast<float>(i), 0.0f));
+            }
+
+            std::snprintf(name, sizeof(name), "%zu receivers", count);
+            Benchmark::report(name, Benchmark::elapsedNanoseconds(start) / static_cast<double>(entityCount));
+        }
+    }
+
+    // Entities reordered and destroyed while events about them are queued, every watched
+    // entity has to get its queued events under the id it had when they were emitted
+    void runEntityScopedBenchmarks()
+    {
+        Benchmark::section("Entity scoped, queued across swaps and destroys, per entity");
+
+        const std::size_t entityCount = 100000;
+
+        EventManager eventManager;
+        EntityManager entityManager(eventManager);
+        eventManager.queueEvents<PingEvent>(EventPhase::PostUpdate);
+        eventManager.queueEvents<EntityDestroyedEvent>(EventPhase::PostUpdate);
+
+        EntityWatcher watcher;
+        std::vector<Entity::Id> ids;
+        for (std::size_t i = 0; i < entityCount; ++i)
+        {
+            const Entity::Id id = entityManager.createEntity().id();
+            eventManager.subscribe<PingEvent>(watcher, id);
+            eventManager.subscribe<EntityDestroyedEvent>(watcher, id);
+            ids.push_back(id);
+        }
+
+        const Benchmark::Clock::time_point start = Benchmark::Clock::now();
+        for (Entity::Id id : ids)
+        {
+            eventManager.emit<PingEvent>(entityManager.getEntity(id));
+        }
+
+        // Every pair trades slots, then the first of every pair is destroyed under its new id
+        for (std::size_t i = 0; i + 1 < ids.size(); i += 2)
+        {
+            entityManager.swapEntities(ids[i], ids[i + 1]);
+            entityManager.destroyEntity(entityManager.createEntityId(ids[i + 1].index()));
+        }
+
+        eventManager.dispatchQueued(EventPhase::PostUpdate);
+        const double nanoseconds = Benchmark::elapsedNanoseconds(start);
+
+        if (watcher.pings != entityCount || watcher.destroyed != entityCount / 2 || eventManager.connectReceivers() != 2 * (entityCount - entityCount / 2))
+        {
+            assert(false && "EventBenchmarks ~ Queued events missed their entity scoped receivers");
+            std::printf("  %zu pings, %zu destroyed, expected %zu and %zu, skipping\n", watcher.pings, watcher.destroyed, entityCount, entityCount / 2);
+            return;
+        }
+
+        Benchmark::report("emit, swap, destroy, dispatch", nanoseconds / static_cast<double>(entityCount));
+    }
+}
+
+void runEventBenchmarks()
+{
+    runSubscribeBenchmarks();
+    runEmitBenchmarks();
+    runReceiverDestructionBenchmarks();
+    runQueuedBenchmarks();
+    runSpawnBenchmarks();
+    runEntityScopedBenchmarks();
+}
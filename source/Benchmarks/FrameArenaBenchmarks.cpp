@@ -0,0 +1,77 @@
+#include <cstdio>
+#include <vector>
+#include <memory_resource>
+
+#include "Benchmark.hpp"
+#include "Helpers/FrameArena.hpp"
+
+namespace
+{
+    const std::size_t AgentCount = 4096;
+    const std::size_t FrameCount = 200;
+
+    // Stand-in for a neighbour query, every agent gets a short list of ids every frame
+    template <typename List>
+    std::size_t gatherNeighbours(std::size_t agent, List& neighbours)
+    {
+        const std::size_t count = 4 + agent % 29;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            neighbours.push_back(static_cast<std::uint32_t>((agent * 31 + i * 17) % AgentCount));
+        }
+
+        return neighbours.size();
+    }
+
+    double runHeapFrames()
+    {
+        std::size_t total = 0;
+        const double nanoseconds = Benchmark::measure(FrameCount, [&]()
+        {
+            std::vector<std::vector<std::uint32_t>> lists(AgentCount);
+            for (std::size_t agent = 0; agent < AgentCount; ++agent)
+            {
+                total += gatherNeighbours(agent, lists[agent]);
+            }
+        });
+
+        Benchmark::keep(total);
+
+        return nanoseconds;
+    }
+
+    double runArenaFrames()
+    {
+        std::size_t total = 0;
+        const double nanoseconds = Benchmark::measure(FrameCount, [&]()
+        {
+            FrameArena::beginFrame();
+            FrameArena& arena = FrameArena::forThisThread();
+
+            std::pmr::vector<std::pmr::vector<std::uint32_t>> lists(AgentCount, &arena);
+            for (std::size_t agent = 0; agent < AgentCount; ++agent)
+            {
+                total += gatherNeighbours(agent, lists[agent]);
+            }
+        });
+
+        Benchmark::keep(total);
+
+        return nanoseconds;
+    }
+}
+
+void runFrameArenaBenchmarks()
+{
+    Benchmark::section("Frame scratch memory (4096 neighbour lists per frame)");
+
+    Benchmark::report("std::vector per frame", runHeapFrames());
+
+    const FrameArena::Stats before = FrameArena::forThisThread().stats();
+    Benchmark::report("std::pmr::vector on FrameArena per frame", runArenaFrames());
+
+    FrameArena::beginFrame();
+    const FrameArena::Stats after = FrameArena::forThisThread().stats();
+    std::printf("  arena high water %.1f KB, %zu blocks allocated over %zu frames (%zu before)\n",
+                after.highWaterBytes / 1024.0, after.upstreamAllocations - before.upstreamAllocations, FrameCount, before.upstreamAllocations);
+}
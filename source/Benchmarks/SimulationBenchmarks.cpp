@@ -0,0 +1,57 @@
+#include <cstdio>
+
+#include "Benchmark.hpp"
+#include "Application/HeadlessRunner.hpp"
+#include "Entity/EntityManager.hpp"
+#include "Components/TransformableComponent.hpp"
+#include "Components/MovementComponent.hpp"
+#include "Components/SteeringComponent.hpp"
+
+namespace
+{
+    void spawnSteeringAgents(EntityManager& entityManager, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            Entity entity = entityManager.createEntity();
+            const sf::Vector2f position(static_cast<float>(i % 1000), static_cast<float>(i / 1000));
+
+            entityManager.assignComponent<TransformableComponent>(entity.id(), position);
+            ComponentPtr<MovementComponent> movement = entityManager.assignComponent<MovementComponent>(entity.id(), 1.0f, 50.0f, 10.0f, 10.0f);
+            movement->velocity = sf::Vector2f(1.0f, 0.5f);
+
+            if (i % 4 == 0)
+            {
+                ComponentPtr<SteeringComponent> steering = entityManager.assignComponent<SteeringComponent>(entity.id());
+                steering->behaviorFlags = BehaviorType::Seek;
+                steering->seekTarget = sf::Vector2f(-500.0f, -500.0f);
+            }
+        }
+    }
+
+    void runHeadless(std::size_t agentCount, std::size_t tickCount, std::size_t workerCount)
+    {
+        HeadlessRunner runner(workerCount);
+        spawnSteeringAgents(runner.getEntityManager(), agentCount);
+        runner.setupSystems();
+
+        const HeadlessRunner::Report report = runner.run(tickCount);
+        std::printf("  %7zu agents, %2zu workers %10.0f ticks/s %8.3f ms/tick (slowest %.3f ms)\n",
+                    agentCount, workerCount, report.ticksPerSecond, report.wallSeconds * 1000.0 / static_cast<double>(report.ticks), report.slowestTickMs);
+    }
+}
+
+void runSimulationBenchmarks()
+{
+    Benchmark::section("Headless simulation");
+
+    runHeadless(10000, 600, 0);
+    runHeadless(100000, 120, 0);
+
+    const std::size_t workers = JobSystem::defaultWorkerCount();
+    if (workers > 0)
+    {
+        runHeadless(10000, 600, workers);
+        runHeadless(100000, 120, workers);
+    }
+}
@@ -0,0 +1,153 @@
+#include <cstdio>
+#include <cstring>
+#include <cassert>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "Entity/EntityManager.hpp"
+#include "EventManagement/EventManager.hpp"
+#include "Serialization/StateDelta.hpp"
+#include "Systems/MovementSystem.hpp"
+#include "Systems/SystemManager.hpp"
+
+namespace
+{
+    // Synthetic steering workload: every entity moves, a quarter of them steer
+    // towards a target the rest drift with a constant velocity.
+    void spawnSteeringAgents(EntityManager& entityManager, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            Entity entity = entityManager.createEntity();
+            const sf::Vector2f position(static_cast<float>(i % 1000), static_cast<float>(i / 1000));
+
+            entityManager.assignComponent<TransformableComponent>(entity.id(), position);
+            ComponentPtr<MovementComponent> movement = entityManager.assignComponent<MovementComponent>(entity.id(), 1.0f, 50.0f, 10.0f, 10.0f);
+            movement->velocity = sf::Vector2f(1.0f, 0.5f);
+
+            if (i % 4 == 0)
+            {
+                ComponentPtr<SteeringComponent> steering = entityManager.assignComponent<SteeringComponent>(entity.id());
+                steering->behaviorFlags = BehaviorType::Seek;
+                steering->seekTarget = sf::Vector2f(-500.0f, -500.0f);
+            }
+        }
+    }
+
+    std::size_t rawStateBytes(EntityManager& entityManager)
+    {
+        std::size_t bytes = 0;
+        for (Entity::Id id : entityManager.getEntityIdsWithComponents<TransformableComponent>())
+        {
+            bytes += sizeof(TransformableComponent);
+            bytes += entityManager.hasComponent<MovementComponent>(id) ? sizeof(MovementComponent) : 0;
+            bytes += entityManager.hasComponent<SteeringComponent>(id) ? sizeof(SteeringComponent) : 0;
+        }
+
+        return bytes;
+    }
+
+    template <typename CompType>
+    bool decodedMatches(EntityManager& entityManager, const StateDeltaDecoder& decoder, Entity::Id id)
+    {
+        const CompType* decoded = decoder.get<CompType>(id.index());
+        if (!entityManager.hasComponent<CompType>(id))
+        {
+            return decoded == nullptr;
+        }
+
+        return decoded && std::memcmp(decoded, entityManager.getComponent<CompType>(id).get(), sizeof(CompType)) == 0;
+    }
+
+    // The decoder's component images have to be byte for byte what the encoder saw
+    bool roundTripMatches(EntityManager& entityManager, const StateDeltaDecoder& decoder)
+    {
+        for (Entity::Id id : entityManager.getEntityIdsWithComponents<TransformableComponent>())
+        {
+            if (!decodedMatches<TransformableComponent>(entityManager, decoder, id) ||
+                !decodedMatches<MovementComponent>(entityManager, decoder, id) ||
+                !decodedMatches<SteeringComponent>(entityManager, decoder, id))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void runSteeringStream(std::size_t agentCount, std::size_t frameCount)
+    {
+        EventManager eventManager;
+        EntityManager entityManager(eventManager);
+        SystemManager systemManager(entityManager, eventManager);
+        systemManager.addSystem<MovementSystem>();
+        systemManager.configure();
+
+        spawnSteeringAgents(entityManager, agentCount);
+
+        StateDeltaEncoder encoder(entityManager);
+        encoder.track<TransformableComponent>();
+        encoder.track<MovementComponent>();
+        encoder.track<SteeringComponent>();
+
+        StateDeltaDecoder decoder;
+        decoder.track<TransformableComponent>();
+        decoder.track<MovementComponent>();
+        decoder.track<SteeringComponent>();
+
+        std::vector<std::uint8_t> buffer;
+        buffer.clear();
+        encoder.encode(buffer);
+        decoder.decode(buffer.data(), buffer.size());
+
+        const std::size_t keyframeBytes = buffer.size();
+        const std::size_t rawBytes = rawStateBytes(entityManager);
+
+        double encodeNs = 0.0;
+        double decodeNs = 0.0;
+        std::size_t deltaBytes = 0;
+
+        for (std::size_t frame = 0; frame < frameCount; ++frame)
+        {
+            systemManager.updateAllSystems(sf::seconds(1.0f / 60.0f));
+
+            buffer.clear();
+            Benchmark::Clock::time_point start = Benchmark::Clock::now();
+            encoder.encode(buffer);
+            encodeNs += Benchmark::elapsedNanoseconds(start);
+
+            start = Benchmark::Clock::now();
+            const bool decoded = decoder.decode(buffer.data(), buffer.size());
+            decodeNs += Benchmark::elapsedNanoseconds(start);
+            Benchmark::keep(decoded);
+
+            deltaBytes += buffer.size();
+
+            // Checked outside the timings, once the first delta went through and at the end
+            if ((frame == 0 || frame + 1 == frameCount) && !(decoded && roundTripMatches(entityManager, decoder)))
+            {
+                assert(false && "StateDeltaBenchmarks ~ Decoded state differs from the encoded one");
+                std::printf("  %zu agents: decoded state differs from the encoded one at frame %zu, skipping\n", agentCount, frame);
+                return;
+            }
+        }
+
+        const double frames = static_cast<double>(frameCount);
+        const double rawMb = static_cast<double>(rawBytes) / (1024.0 * 1024.0);
+
+        std::printf("  %zu agents, %zu frames\n", agentCount, frameCount);
+        std::printf("    raw state            %10zu bytes/frame\n", rawBytes);
+        std::printf("    keyframe             %10zu bytes (%.2fx)\n", keyframeBytes, static_cast<double>(rawBytes) / keyframeBytes);
+        std::printf("    delta                %10.0f bytes/frame (%.2fx)\n", deltaBytes / frames, rawBytes * frames / deltaBytes);
+        std::printf("    encode               %10.3f ms/frame (%.0f MB/s raw)\n", encodeNs / frames / 1e6, rawMb / (encodeNs / frames / 1e9));
+        std::printf("    decode               %10.3f ms/frame (%.0f MB/s raw)\n", decodeNs / frames / 1e6, rawMb / (decodeNs / frames / 1e9));
+    }
+}
+
+void runStateDeltaBenchmarks()
+{
+    Benchmark::section("StateDelta steering streams");
+
+    runSteeringStream(10000, 120);
+    runSteeringStream(100000, 30);
+}
@@ -6,10 +6,14 @@
 #include "Entity/Entity.hpp"
 
 class EntityManager;
+class BasePool;
 
 template <typename CompType, class EManager = EntityManager>
 class ComponentPtr;
 
+template <typename CompType, class EManager = EntityManager>
+class ComponentRef;
+
 // Internal class, do not use this to define components
 class BaseComponent
 {
@@ -39,6 +43,10 @@ class BaseComponent
 
             return familyCounter++;
         }
+
+    private:
+        // Runtime defined components take their family bits from the same counter
+        friend class RuntimeComponentRegistry;
 };
 
 // User facing class, if you are defining a new component
@@ -49,6 +57,7 @@ class Component : public BaseComponent
     public:
         using Ptr = ComponentPtr<Derived>;
         using ConstPtr = ComponentPtr<const Derived, const EntityManager>;
+        using Ref = ComponentRef<Derived>;
 
     private:
         static Family family();
@@ -90,4 +99,50 @@ class ComponentPtr
         Entity::Id owningEntityId;
 };
 
+// A long lived reference to a component owned by another entity. Pool chunks never
+// move, so the raw component pointer is cached together with the version of the
+// owning entity. Revalidating is a version compare and a test of the entity's component
+// mask, dereferencing is one load, unlike ComponentPtr which resolves the pool slot on
+// every access. Like ComponentPtr every access counts as a write, for checkpoints and
+// indexes, which costs two flag tests while neither tracks writes.
+//
+// NOTE: The reference follows the lifetime of the owning entity and of the component, it
+// goes invalid once either is gone. A component assigned again afterwards needs a new
+// reference.
+template <typename CompType, class EManager>
+class ComponentRef
+{
+    public:
+        ComponentRef() : component(nullptr), entityManager(nullptr), pool(nullptr) {}
+
+        bool valid() const;
+        Entity::Id owner() const { return owningEntityId; }
+
+        CompType* get() const;
+
+        operator bool() const;
+
+        CompType* operator->() const;
+        CompType& operator*() const;
+
+        bool operator==(const ComponentRef& rhs) const { return component == rhs.component && owningEntityId == rhs.owningEntityId; }
+        bool operator!=(const ComponentRef& rhs) const { return !(*this == rhs); }
+
+    private:
+        ComponentRef(const EManager* manager, Entity::Id id, CompType* comp, BasePool* pool)
+            : component(comp)
+            , entityManager(manager)
+            , pool(pool)
+            , owningEntityId(id)
+        {}
+
+    private:
+        friend class EntityManager;
+
+        CompType* component;
+        const EManager* entityManager;
+        BasePool* pool;
+        Entity::Id owningEntityId;
+};
+
 #include "Component.inl"
\ No newline at end of file
@@ -75,4 +75,41 @@ template <typename CompType, typename EManager>
 bool ComponentPtr<CompType, EManager>::operator!=(const ComponentPtr<CompType>& rhs) const
 {
     return !(*this == rhs);
-}
\ No newline at end of file
+}
+
+template <typename CompType, typename EManager>
+bool ComponentRef<CompType, EManager>::valid() const
+{
+    // The entity is checked first, its mask might belong to a newer entity in the same slot
+    return component &&
+           entityManager->entityVersion(owningEntityId.index()) == owningEntityId.version() &&
+           entityManager->entityComponentMasks[owningEntityId.index()].test(EManager::template componentFamily<CompType>());
+}
+
+template <typename CompType, typename EManager>
+CompType* ComponentRef<CompType, EManager>::get() const
+{
+    assert(valid());
+
+    pool->touch(owningEntityId.index());
+
+    return component;
+}
+
+template <typename CompType, typename EManager>
+ComponentRef<CompType, EManager>::operator bool() const
+{
+    return valid();
+}
+
+template <typename CompType, typename EManager>
+CompType* ComponentRef<CompType, EManager>::operator->() const
+{
+    return get();
+}
+
+template <typename CompType, typename EManager>
+CompType& ComponentRef<CompType, EManager>::operator*() const
+{
+    return *get();
+}
@@ -3,6 +3,8 @@
 #include <SFML/Graphics/VertexArray.hpp>
 #include <SFML/Graphics/Texture.hpp>
 
+#include <memory>
+
 #include "ResourceManagement/ResourceHandle.hpp"
 
 // NOTE: Again this whole rendering design will be rewritten in the near future to remove SFML from the rendering pipeline
@@ -15,21 +17,23 @@ struct RenderableComponent
     RenderableComponent(const std::shared_ptr<ResourceHandle>& textureHandle, const sf::FloatRect& textureRect);
 
     sf::VertexArray vertexArray;
-    sf::Texture texture;
+    std::shared_ptr<const sf::Texture> texture; // Shared so a RenderSnapshot can keep it alive past the component
     sf::FloatRect textureRect;
 };
 
 inline RenderableComponent::RenderableComponent(const std::shared_ptr<ResourceHandle>& textureHandle)
     : vertexArray(sf::TriangleStrip, 4)
 {
-    if (!texture.loadFromMemory(textureHandle->GetBuffer(), textureHandle->GetSize()))
+    auto loaded = std::make_shared<sf::Texture>();
+    if (!loaded->loadFromMemory(textureHandle->GetBuffer(), textureHandle->GetSize()))
     {
         // TODO: Log failure to load the texture from the resource handle.
     }
 
+    texture = std::move(loaded);
     textureRect = sf::FloatRect(0.0f, 0.0f,
-                                static_cast<float>(texture.getSize().x),
-                                static_cast<float>(texture.getSize().y));
+                                static_cast<float>(texture->getSize().x),
+                                static_cast<float>(texture->getSize().y));
 
     vertexArray[0].position = sf::Vector2f(0.0f, 0.0f);
     vertexArray[1].position = sf::Vector2f(0.0f, textureRect.height);
@@ -51,11 +55,14 @@ inline RenderableComponent::RenderableComponent(const std::shared_ptr<ResourceHa
         : vertexArray(sf::TriangleStrip, 4)
         , textureRect(textureRect)
 {
-    if (!texture.loadFromMemory(textureHandle->GetBuffer(), textureHandle->GetSize()))
+    auto loaded = std::make_shared<sf::Texture>();
+    if (!loaded->loadFromMemory(textureHandle->GetBuffer(), textureHandle->GetSize()))
     {
         // TODO: Log failure to load the texture from the resource handle.
     }
 
+    texture = std::move(loaded);
+
     vertexArray[0].position = sf::Vector2f(0.0f, 0.0f);
     vertexArray[1].position = sf::Vector2f(0.0f, textureRect.height);
     vertexArray[2].position = sf::Vector2f(textureRect.width, 0.0f);
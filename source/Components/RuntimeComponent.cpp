@@ -0,0 +1,89 @@
+#include "RuntimeComponent.hpp"
+
+const RuntimeComponentType& RuntimeComponentRegistry::registerComponent(const std::string& name, std::size_t size, std::size_t alignment, std::vector<Field> fields)
+{
+    assert(size > 0 && "RuntimeComponentRegistry ~ Component size must be greater than zero");
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0 && "RuntimeComponentRegistry ~ Alignment must be a power of two");
+    assert(alignment <= alignof(std::max_align_t) && "RuntimeComponentRegistry ~ Pool chunks are only aligned to max_align_t");
+
+    for (const Field& field : fields)
+    {
+        assert(field.offset + fieldSize(field.type) <= size && "RuntimeComponentRegistry ~ Field is outside the component");
+    }
+
+    // Pool elements are laid out back to back, so round the size up to keep every element aligned
+    const std::size_t paddedSize = (size + alignment - 1) & ~(alignment - 1);
+
+    if (const RuntimeComponentType* existing = find(name))
+    {
+        assert(existing->size() == paddedSize && existing->alignment() == alignment && "RuntimeComponentRegistry ~ Type registered twice with a different layout");
+
+        return *existing;
+    }
+
+    const BaseComponent::Family family = BaseComponent::familyCounter();
+    assert(family < 64 && "RuntimeComponentRegistry ~ Out of component families, EntityManager::ComponentMask holds 64");
+
+    types().emplace_back(new RuntimeComponentType(name, family, paddedSize, alignment, std::move(fields)));
+
+    return *types().back();
+}
+
+const RuntimeComponentType* RuntimeComponentRegistry::find(const std::string& name)
+{
+    for (const std::unique_ptr<RuntimeComponentType>& type : types())
+    {
+        if (type->name() == name)
+        {
+            return type.get();
+        }
+    }
+
+    return nullptr;
+}
+
+std::size_t RuntimeComponentRegistry::fieldSize(FieldType type)
+{
+    switch (type)
+    {
+        case FieldType::Int32:
+        case FieldType::UInt32:
+        case FieldType::Float:
+            return 4;
+        case FieldType::Double:
+            return 8;
+        case FieldType::Bool:
+            return 1;
+        case FieldType::Bytes:
+        default:
+            return 0;
+    }
+}
+
+std::vector<std::unique_ptr<RuntimeComponentType>>& RuntimeComponentRegistry::types()
+{
+    static std::vector<std::unique_ptr<RuntimeComponentType>> registered;
+
+    return registered;
+}
+
+const RuntimeComponentType::Field* RuntimeComponentType::findField(const std::string& name) const
+{
+    for (const Field& field : typeFields)
+    {
+        if (field.name == name)
+        {
+            return &field;
+        }
+    }
+
+    return nullptr;
+}
+
+std::bitset<64> RuntimeComponentType::mask() const
+{
+    std::bitset<64> compMask;
+    compMask.set(typeFamily);
+
+    return compMask;
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <string>
+#include <vector>
+#include <memory>
+#include <bitset>
+
+#include "Components/Component.hpp"
+
+// Component types that only exist at runtime (designer defined stats, tool generated data).
+// They are described by a size, an alignment and an optional field layout, get a family bit
+// out of the same counter as the compiled components and live in a regular pool, so views can
+// mix them with static components.
+//
+//      RuntimeComponentRegistry::Field fields[] = {
+//          { "health", RuntimeComponentRegistry::FieldType::Float, 0 },
+//          { "armor", RuntimeComponentRegistry::FieldType::Int32, 4 } };
+//      const RuntimeComponentType& stats = RuntimeComponentRegistry::registerComponent("Stats", 8, 4, fields);
+//
+//      entityManager.assignComponent(entity.id(), stats);
+//      stats.field<float>(entityManager.getComponent(entity.id(), stats), "health") = 100.0f;
+//
+// NOTE: The data is treated as POD. It is zero filled (or copied from the initial value) on
+// assign and nothing is run when it is removed.
+class RuntimeComponentType;
+
+class RuntimeComponentRegistry
+{
+    public:
+        enum class FieldType : std::uint8_t
+        {
+            Int32,
+            UInt32,
+            Float,
+            Double,
+            Bool,
+            Bytes // Opaque, only the offset is checked against the component size
+        };
+
+        struct Field
+        {
+            std::string name;
+            FieldType type;
+            std::size_t offset;
+        };
+
+        // Registering a name twice returns the existing type, the layout has to match.
+        template <std::size_t FieldCount>
+        static const RuntimeComponentType& registerComponent(const std::string& name, std::size_t size, std::size_t alignment, const Field (&fields)[FieldCount])
+        {
+            return registerComponent(name, size, alignment, std::vector<Field>(fields, fields + FieldCount));
+        }
+
+        static const RuntimeComponentType& registerComponent(const std::string& name, std::size_t size, std::size_t alignment, std::vector<Field> fields = {});
+
+        // nullptr if no type with that name was registered
+        static const RuntimeComponentType* find(const std::string& name);
+
+        static std::size_t fieldSize(FieldType type);
+
+    private:
+        static std::vector<std::unique_ptr<RuntimeComponentType>>& types();
+};
+
+class RuntimeComponentType
+{
+    public:
+        using Field = RuntimeComponentRegistry::Field;
+
+        const std::string& name() const { return typeName; }
+        BaseComponent::Family family() const { return typeFamily; }
+        std::size_t size() const { return typeSize; }
+        std::size_t alignment() const { return typeAlignment; }
+        const std::vector<Field>& fields() const { return typeFields; }
+
+        // nullptr if the layout has no field with that name
+        const Field* findField(const std::string& name) const;
+
+        // Mask with the family bit of this type, combine it with the masks of other types
+        // to query views (see EntityManager::getEntitiesWithComponents).
+        std::bitset<64> mask() const;
+
+        template <typename T>
+        T& field(void* component, const std::string& name) const;
+
+        template <typename T>
+        const T& field(const void* component, const std::string& name) const;
+
+    private:
+        RuntimeComponentType(const std::string& name, BaseComponent::Family family, std::size_t size, std::size_t alignment, std::vector<Field> fields)
+            : typeName(name)
+            , typeFamily(family)
+            , typeSize(size)
+            , typeAlignment(alignment)
+            , typeFields(std::move(fields))
+        {}
+
+    private:
+        friend class RuntimeComponentRegistry;
+
+        std::string typeName;
+        BaseComponent::Family typeFamily;
+        std::size_t typeSize;
+        std::size_t typeAlignment;
+        std::vector<Field> typeFields;
+};
+
+template <typename T>
+T& RuntimeComponentType::field(void* component, const std::string& name) const
+{
+    const Field* found = findField(name);
+    assert(found && "RuntimeComponentType ~ Unknown field");
+    assert(found->offset + sizeof(T) <= typeSize && "RuntimeComponentType ~ Field type does not fit the component");
+
+    return *reinterpret_cast<T*>(static_cast<char*>(component) + found->offset);
+}
+
+template <typename T>
+const T& RuntimeComponentType::field(const void* component, const std::string& name) const
+{
+    const Field* found = findField(name);
+    assert(found && "RuntimeComponentType ~ Unknown field");
+    assert(found->offset + sizeof(T) <= typeSize && "RuntimeComponentType ~ Field type does not fit the component");
+
+    return *reinterpret_cast<const T*>(static_cast<const char*>(component) + found->offset);
+}
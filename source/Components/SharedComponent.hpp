@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+#include <vector>
+#include <utility>
+#include <type_traits>
+
+#include "Entity/Entity.hpp"
+#include "Helpers/MemoryPool.hpp"
+
+// Flyweight components. The value is stored once in a SharedComponentStore owned by
+// EntityManager and every entity using it carries a SharedComponent<CompType>, a 4 byte
+// index into the store, in a regular pool. Values are refcounted by the entities that
+// use them plus one reference held by whoever created the value.
+//
+//      SharedComponent<RenderableComponent> sprite = entityManager.createSharedComponent<RenderableComponent>(handle);
+//      entityManager.assignComponent<SharedComponent<RenderableComponent>>(entity.id(), sprite);
+//      entityManager.releaseSharedComponent(sprite); // Entities keep it alive from here on
+template <typename CompType>
+struct SharedComponent
+{
+    SharedComponent() : index(~0U) {}
+    explicit SharedComponent(std::uint32_t index) : index(index) {}
+
+    bool operator==(const SharedComponent& other) const { return index == other.index; }
+    bool operator!=(const SharedComponent& other) const { return index != other.index; }
+
+    std::uint32_t index;
+};
+
+// The refcounts in the store are not part of checkpoints, so keep shared components
+// out of anything that gets rolled back.
+template <typename CompType>
+struct BitwiseRestorable<SharedComponent<CompType>> : std::false_type {};
+
+template <typename T>
+struct IsSharedComponent : std::false_type {};
+
+template <typename CompType>
+struct IsSharedComponent<SharedComponent<CompType>> : std::true_type
+{
+    using ValueType = CompType;
+};
+
+// A run of entities that all reference the same shared value, see
+// EntityManager::getEntitiesGroupedBy().
+template <typename CompType>
+struct SharedComponentGroup
+{
+    SharedComponent<CompType> shared;
+    CompType* value;
+    const Entity::Id* first;
+    const Entity::Id* last;
+
+    const Entity::Id* begin() const { return first; }
+    const Entity::Id* end() const { return last; }
+    std::size_t size() const { return static_cast<std::size_t>(last - first); }
+};
+
+class BaseSharedComponentStore
+{
+    public:
+        virtual ~BaseSharedComponentStore() {}
+
+        // Drops the reference held by the entity at entityIndex of pool (the SharedComponent pool).
+        virtual void releaseEntity(const BasePool& pool, std::size_t entityIndex) = 0;
+};
+
+template <typename CompType>
+class SharedComponentStore : public BaseSharedComponentStore
+{
+    public:
+        ~SharedComponentStore() override
+        {
+            for (std::uint32_t i = 0; i < refCounts.size(); ++i)
+            {
+                if (refCounts[i] > 0)
+                {
+                    values.destroy(i);
+                }
+            }
+        }
+
+        template <typename ... Args>
+        std::uint32_t create(Args&& ... args)
+        {
+            std::uint32_t index;
+            if (freeSlots.empty())
+            {
+                index = static_cast<std::uint32_t>(refCounts.size());
+                values.expand(index + 1);
+                refCounts.push_back(0);
+            }
+            else
+            {
+                index = freeSlots.back();
+                freeSlots.pop_back();
+            }
+
+            new(values.get(index)) CompType(std::forward<Args>(args)...);
+            refCounts[index] = 1;
+
+            return index;
+        }
+
+        void addRef(std::uint32_t index)
+        {
+            assert(valid(index) && "SharedComponentStore ~ Referencing a released shared component");
+            ++refCounts[index];
+        }
+
+        void release(std::uint32_t index)
+        {
+            assert(valid(index) && "SharedComponentStore ~ Releasing a released shared component");
+            if (--refCounts[index] == 0)
+            {
+                values.destroy(index);
+                freeSlots.push_back(index);
+            }
+        }
+
+        void releaseEntity(const BasePool& pool, std::size_t entityIndex) override
+        {
+            release(static_cast<const SharedComponent<CompType>*>(pool.get(entityIndex))->index);
+        }
+
+        bool valid(std::uint32_t index) const { return index < refCounts.size() && refCounts[index] > 0; }
+        std::uint32_t refCount(std::uint32_t index) const { return valid(index) ? refCounts[index] : 0; }
+        std::size_t size() const { return refCounts.size() - freeSlots.size(); }
+        std::size_t capacity() const { return refCounts.size(); }
+
+        CompType& get(std::uint32_t index)
+        {
+            assert(valid(index));
+            return *static_cast<CompType*>(values.get(index));
+        }
+
+    private:
+        friend class EntityManager;
+
+        Pool<CompType, 64> values;
+        std::vector<std::uint32_t> refCounts;
+        std::vector<std::uint32_t> freeSlots;
+
+        // Scratch for EntityManager::getEntitiesGroupedBy(), reused between calls
+        std::vector<std::pair<std::uint32_t, Entity::Id>> groupScratch;
+        std::vector<std::uint32_t> groupOffsets;
+        std::vector<Entity::Id> groupedIds;
+        std::vector<SharedComponentGroup<CompType>> groups;
+};
@@ -38,7 +38,7 @@ struct SteeringComponent
         Deceleration arriveDeceleration;
 
         // Pursuit
-        Entity pursuitTarget;
+        EntityHandle pursuitTarget;
 };
 
 // Scoped enums need to implement their own operators
@@ -2,6 +2,7 @@
 
 #include <SFML/Graphics/Transformable.hpp>
 #include "SFML/System/Vector2.hpp"
+#include "Helpers/MemoryPool.hpp"
 
 struct TransformableComponent : public sf::Transformable
 {
@@ -17,3 +18,8 @@ struct TransformableComponent : public sf::Transformable
         setOrigin(origin);
     }
 };
+
+// sf::Transformable only holds plain floats and cached matrices, the virtual destructor is
+// the only thing keeping it from being trivially copyable.
+template <>
+struct BitwiseRestorable<TransformableComponent> : std::true_type {};
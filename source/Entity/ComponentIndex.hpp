@@ -0,0 +1,244 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <optional>
+#include <functional>
+#include <type_traits>
+#include <algorithm>
+#include <bitset>
+
+#include "Entity/Entity.hpp"
+#include "Helpers/MemoryPool.hpp"
+
+class EntityManager;
+
+// Internal interface EntityManager uses to keep the indexes up to date
+class BaseComponentIndex
+{
+    public:
+        explicit BaseComponentIndex(std::size_t family) : family(family) {}
+        virtual ~BaseComponentIndex() {}
+
+        std::size_t componentFamily() const { return family; }
+
+        virtual void componentAdded(std::uint32_t index) = 0;
+        virtual void componentRemoved(std::uint32_t index) = 0;
+        virtual void componentChanged(std::uint32_t index) = 0;
+        virtual void entitiesSwapped(std::uint32_t first, std::uint32_t second) = 0;
+        virtual void rebuild() = 0;
+
+    private:
+        std::size_t family;
+};
+
+// Secondary index from a projection of CompType to the entities holding it, created
+// through EntityManager::createHashIndex/createSortedIndex.
+//
+//      auto& fleeing = entityManager.createHashIndex<SteeringComponent>([](const SteeringComponent& steering)
+//      {
+//          return (steering.behaviorFlags & BehaviorType::Flee) == BehaviorType::Flee;
+//      });
+//
+//      for (Entity::Id id : fleeing.find(true)) { ... }
+//
+// Adds, removes, destroys and swaps are applied as they happen. Component writes are picked up
+// through the change tracking of the pool (every mutable ComponentPtr access counts as one), the
+// touched entities are re-projected on the next query.
+//
+// NOTE: The returned vectors are valid until the next query on the index or the next structural
+// change, and the order of the entities in them is unspecified. Indexes are dropped by
+// EntityManager::reset().
+template <typename CompType, typename Key, typename Buckets, class EManager = EntityManager>
+class ComponentIndex : public BaseComponentIndex
+{
+    public:
+        using ComponentType = CompType;
+        using KeyType = Key;
+        using Projection = std::function<Key (const CompType&)>;
+
+        ComponentIndex(EManager* manager, std::size_t family, const BasePool* pool, Projection projection)
+            : BaseComponentIndex(family)
+            , entityManager(manager)
+            , pool(pool)
+            , projection(std::move(projection))
+        {}
+
+        // Entities whose component projects to key
+        const std::vector<Entity::Id>& find(const Key& key);
+
+        std::size_t count(const Key& key) { return find(key).size(); }
+
+        // Sorted indexes only. Calls callback(key, entities) for every key in [first, last].
+        template <typename Callback>
+        void forEachInRange(const Key& first, const Key& last, Callback callback);
+
+        // Number of indexed entities
+        std::size_t size() const { return indexedCount; }
+
+        virtual void componentAdded(std::uint32_t index) override;
+        virtual void componentRemoved(std::uint32_t index) override;
+        virtual void componentChanged(std::uint32_t index) override;
+        virtual void entitiesSwapped(std::uint32_t first, std::uint32_t second) override;
+        virtual void rebuild() override;
+
+    private:
+        void insert(std::uint32_t index, const Key& key);
+        void erase(std::uint32_t index);
+
+        const CompType& component(std::uint32_t index) const { return *static_cast<const CompType*>(pool->get(index)); }
+
+    private:
+        EManager* entityManager;
+        const BasePool* pool;
+        Projection projection;
+        Buckets buckets;
+
+        // Indexed by entity index, the key the entity is filed under and its slot in the bucket
+        std::vector<std::optional<Key>> keys;
+        std::vector<std::uint32_t> slots;
+        std::size_t indexedCount = 0;
+};
+
+template <typename CompType, typename Key>
+using HashIndex = ComponentIndex<CompType, Key, std::unordered_map<Key, std::vector<Entity::Id>>>;
+
+template <typename CompType, typename Key>
+using SortedIndex = ComponentIndex<CompType, Key, std::map<Key, std::vector<Entity::Id>>>;
+
+template <typename CompType, typename Projection>
+using ProjectedKey = std::decay_t<std::invoke_result_t<Projection&, const CompType&>>;
+
+template <typename CompType, typename Key, typename Buckets, class EManager>
+const std::vector<Entity::Id>& ComponentIndex<CompType, Key, Buckets, EManager>::find(const Key& key)
+{
+    static const std::vector<Entity::Id> empty;
+
+    entityManager->flushComponentChanges(componentFamily());
+
+    auto it = buckets.find(key);
+    return it != buckets.end() ? it->second : empty;
+}
+
+template <typename CompType, typename Key, typename Buckets, class EManager>
+template <typename Callback>
+void ComponentIndex<CompType, Key, Buckets, EManager>::forEachInRange(const Key& first, const Key& last, Callback callback)
+{
+    entityManager->flushComponentChanges(componentFamily());
+
+    for (auto it = buckets.lower_bound(first); it != buckets.end() && !(last < it->first); ++it)
+    {
+        callback(it->first, it->second);
+    }
+}
+
+template <typename CompType, typename Key, typename Buckets, class EManager>
+void ComponentIndex<CompType, Key, Buckets, EManager>::componentAdded(std::uint32_t index)
+{
+    insert(index, projection(component(index)));
+}
+
+template <typename CompType, typename Key, typename Buckets, class EManager>
+void ComponentIndex<CompType, Key, Buckets, EManager>::componentRemoved(std::uint32_t index)
+{
+    erase(index);
+}
+
+template <typename CompType, typename Key, typename Buckets, class EManager>
+void ComponentIndex<CompType, Key, Buckets, EManager>::componentChanged(std::uint32_t index)
+{
+    assert(index < keys.size() && keys[index] && "ComponentIndex ~ Changed component was never indexed");
+
+    Key key = projection(component(index));
+    if (!(key == *keys[index]))
+    {
+        erase(index);
+        insert(index, key);
+    }
+}
+
+template <typename CompType, typename Key, typename Buckets, class EManager>
+void ComponentIndex<CompType, Key, Buckets, EManager>::entitiesSwapped(std::uint32_t first, std::uint32_t second)
+{
+    const std::uint32_t larger = std::max(first, second);
+    if (keys.size() <= larger)
+    {
+        keys.resize(larger + 1);
+        slots.resize(larger + 1);
+    }
+
+    std::swap(keys[first], keys[second]);
+    std::swap(slots[first], slots[second]);
+
+    // Both slots got a new version, patch the ids filed under them
+    for (std::uint32_t index : { first, second })
+    {
+        if (keys[index])
+        {
+            buckets[*keys[index]][slots[index]] = entityManager->createEntityId(index);
+        }
+    }
+}
+
+template <typename CompType, typename Key, typename Buckets, class EManager>
+void ComponentIndex<CompType, Key, Buckets, EManager>::rebuild()
+{
+    buckets.clear();
+    keys.clear();
+    slots.clear();
+    indexedCount = 0;
+
+    const std::vector<std::bitset<64>>& masks = entityManager->allComponentMasks();
+    for (std::uint32_t index = 0; index < masks.size(); ++index)
+    {
+        if (masks[index].test(componentFamily()))
+        {
+            componentAdded(index);
+        }
+    }
+}
+
+template <typename CompType, typename Key, typename Buckets, class EManager>
+void ComponentIndex<CompType, Key, Buckets, EManager>::insert(std::uint32_t index, const Key& key)
+{
+    if (keys.size() <= index)
+    {
+        keys.resize(index + 1);
+        slots.resize(index + 1);
+    }
+
+    assert(!keys[index] && "ComponentIndex ~ Entity is already indexed");
+
+    std::vector<Entity::Id>& bucket = buckets[key];
+    keys[index] = key;
+    slots[index] = static_cast<std::uint32_t>(bucket.size());
+    bucket.push_back(entityManager->createEntityId(index));
+    ++indexedCount;
+}
+
+template <typename CompType, typename Key, typename Buckets, class EManager>
+void ComponentIndex<CompType, Key, Buckets, EManager>::erase(std::uint32_t index)
+{
+    assert(index < keys.size() && keys[index] && "ComponentIndex ~ Entity is not indexed");
+
+    auto it = buckets.find(*keys[index]);
+    std::vector<Entity::Id>& bucket = it->second;
+
+    // Swap with the last entity of the bucket to keep the removal O(1)
+    const Entity::Id last = bucket.back();
+    bucket[slots[index]] = last;
+    slots[last.index()] = slots[index];
+    bucket.pop_back();
+
+    if (bucket.empty())
+    {
+        buckets.erase(it);
+    }
+
+    keys[index].reset();
+    --indexedCount;
+}
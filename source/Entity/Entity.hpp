@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <cassert>
 
 class EntityManager;
 
@@ -49,4 +50,49 @@ class Entity
     private:
         Entity::Id internalId;
         EntityManager* entityManager;
-};
\ No newline at end of file
+};
+
+// Compact 32-bit reference to an entity, meant to be stored inside components in place of
+// Entity (16 bytes). The low IndexBits hold the entity index and the remaining bits hold the
+// low bits of the entity version, so a handle goes stale once its entity is destroyed.
+// Resolve it back to an Entity::Id through EntityManager::resolve() before use.
+//
+// NOTE: Only the low bits of the version are kept, a handle can alias a newer entity after
+// 2^(32 - IndexBits) version bumps of the same index, 256 with the default 24 index bits.
+// destroyEntity() and swapEntities() both bump the version, and SpatialReorderSystem can swap
+// a slot that often within a single plan. Handles stored in components have to be rewritten
+// as their entity moves (see SpatialReorderSystem for SteeringComponent::pursuitTarget), not
+// resolved afterwards.
+template <unsigned IndexBits = 24>
+class BasicEntityHandle
+{
+    static_assert(IndexBits > 0 && IndexBits < 32, "BasicEntityHandle ~ Need at least one bit for both the index and the generation");
+
+    public:
+        static constexpr std::uint32_t INDEX_MASK = (1U << IndexBits) - 1U;
+        static constexpr std::uint32_t GENERATION_MASK = ~0U >> IndexBits;
+
+        BasicEntityHandle() : packed(~0U) {}
+        explicit BasicEntityHandle(Entity::Id id)
+            : packed(id == Entity::INVALID_ID ? ~0U : (id.index() & INDEX_MASK) | (id.version() & GENERATION_MASK) << IndexBits)
+        {
+            // The all ones index is reserved for the invalid handle.
+            assert((id == Entity::INVALID_ID || id.index() < INDEX_MASK) && "BasicEntityHandle ~ Entity index does not fit in the handle");
+        }
+
+        std::uint32_t index() const { return packed & INDEX_MASK; }
+        std::uint32_t generation() const { return packed >> IndexBits; }
+        std::uint32_t getPacked() const { return packed; }
+
+        bool isNull() const { return packed == ~0U; }
+        bool matches(std::uint32_t version) const { return !isNull() && (version & GENERATION_MASK) == generation(); }
+
+        bool operator==(const BasicEntityHandle& other) const { return packed == other.packed; }
+        bool operator!=(const BasicEntityHandle& other) const { return packed != other.packed; }
+        bool operator<(const BasicEntityHandle& other) const { return packed < other.packed; }
+
+    private:
+        std::uint32_t packed;
+};
+
+using EntityHandle = BasicEntityHandle<>;
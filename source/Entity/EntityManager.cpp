@@ -1,8 +1,12 @@
 #include "EntityManager.hpp"
 #include "EventManagement/Events/EntityEvents.hpp"
+#include "Components/RuntimeComponent.hpp"
 
-EntityManager::EntityManager(EventManager& eventManager)
+EntityManager::EntityManager(EventManager& eventManager, ChunkStorage* storage)
     : eventManager(eventManager)
+    , storage(storage ? storage : ChunkStorage::heap())
+    , entityComponentMasks(this->storage)
+    , entityVersions(this->storage)
 {}
 
 EntityManager::~EntityManager()
@@ -47,11 +51,15 @@ void EntityManager::destroyEntity(Entity::Id entityId)
     auto compMask = entityComponentMasks[index];
 
     eventManager.emit<EntityDestroyedEvent>(Entity(this, entityId));
+    eventManager.dropEntitySubscriptions(entityId);
     for (size_t i = 0; i < componentPools.size(); ++i)
     {
         BasePool* pool = componentPools[i];
         if (pool && compMask.test(i))
         {
+            indexComponentRemoved(i, index);
+            releaseShared(i, index);
+            touchForStructuralChange(pool, index);
             pool->destroy(index);
         }
     }
@@ -76,6 +84,8 @@ bool EntityManager::validEntity(Entity::Id id) const
 
 void EntityManager::reset()
 {
+    endCheckpoint();
+
     // Destroy all entities, entitiesForDebugging() will return 
     // every single entity the manager is tracking.
     for (Entity entity : entitiesForDebugging())
@@ -93,7 +103,16 @@ void EntityManager::reset()
         }
     }
 
+    componentIndexes.clear();
+
+    // Values still alive here are only held by their creators
+    for (BaseSharedComponentStore* store : sharedStores)
+    {
+        delete store;
+    }
+
     componentPools.clear();
+    sharedStores.clear();
     entityComponentMasks.clear();
     entityVersions.clear();
     freeIds.clear();
@@ -101,6 +120,260 @@ void EntityManager::reset()
     indexCounter = 0;
 }
 
+void* EntityManager::assignComponent(Entity::Id id, const RuntimeComponentType& type, const void* initial)
+{
+    assertValidId(id);
+
+    const BaseComponent::Family family = type.family();
+    assert(!entityComponentMasks[id.index()].test(family));
+
+    BasePool* pool = accomodateComponent(type);
+    touchForStructuralChange(pool, id.index());
+
+    void* data = pool->get(id.index());
+    if (initial)
+    {
+        std::memcpy(data, initial, type.size());
+    }
+    else
+    {
+        std::memset(data, 0, type.size());
+    }
+
+    entityComponentMasks[id.index()].set(family);
+
+    return data;
+}
+
+void EntityManager::removeComponent(Entity::Id id, const RuntimeComponentType& type)
+{
+    assertValidId(id);
+    assert(hasComponent(id, type));
+
+    const BaseComponent::Family family = type.family();
+    BasePool* pool = componentPools[family];
+
+    entityComponentMasks[id.index()].reset(family);
+    touchForStructuralChange(pool, id.index());
+    pool->destroy(id.index());
+}
+
+bool EntityManager::hasComponent(Entity::Id id, const RuntimeComponentType& type) const
+{
+    assertValidId(id);
+
+    const BaseComponent::Family family = type.family();
+    return family < componentPools.size() && componentPools[family] && entityComponentMasks[id.index()][family];
+}
+
+void* EntityManager::getComponent(Entity::Id id, const RuntimeComponentType& type)
+{
+    if (!hasComponent(id, type))
+    {
+        return nullptr;
+    }
+
+    // Handing out a mutable pointer counts as a write for checkpoints
+    BasePool* pool = componentPools[type.family()];
+    pool->touch(id.index());
+
+    return pool->get(id.index());
+}
+
+const void* EntityManager::getComponent(Entity::Id id, const RuntimeComponentType& type) const
+{
+    if (!hasComponent(id, type))
+    {
+        return nullptr;
+    }
+
+    return componentPools[type.family()]->get(id.index());
+}
+
+void EntityManager::swapEntities(Entity::Id first, Entity::Id second)
+{
+    assertValidId(first);
+    assertValidId(second);
+
+    const uint32_t firstIndex = first.index();
+    const uint32_t secondIndex = second.index();
+    if (firstIndex == secondIndex)
+    {
+        return;
+    }
+
+    const ComponentMask firstMask = entityComponentMasks[firstIndex];
+    const ComponentMask secondMask = entityComponentMasks[secondIndex];
+
+    for (size_t i = 0; i < componentPools.size(); ++i)
+    {
+        BasePool* pool = componentPools[i];
+        if (pool && (firstMask.test(i) || secondMask.test(i)))
+        {
+            touchForStructuralChange(pool, firstIndex);
+            touchForStructuralChange(pool, secondIndex);
+            pool->swap(firstIndex, secondIndex, firstMask.test(i), secondMask.test(i));
+        }
+    }
+
+    entityComponentMasks[firstIndex] = secondMask;
+    entityComponentMasks[secondIndex] = firstMask;
+
+    // New versions for both slots so nothing taken before the swap resolves to the wrong entity
+    entityVersions[firstIndex]++;
+    entityVersions[secondIndex]++;
+
+    for (const std::unique_ptr<BaseComponentIndex>& index : componentIndexes)
+    {
+        index->entitiesSwapped(firstIndex, secondIndex);
+    }
+
+    // Entity scoped subscriptions follow the entities to their new ids
+    eventManager.moveEntitySubscriptions(first, createEntityId(secondIndex));
+    eventManager.moveEntitySubscriptions(second, createEntityId(firstIndex));
+
+    eventManager.emit<EntityMovedEvent>(first, Entity(this, createEntityId(secondIndex)));
+    eventManager.emit<EntityMovedEvent>(second, Entity(this, createEntityId(firstIndex)));
+}
+
+void EntityManager::beginCheckpoint()
+{
+    if (!checkpoint)
+    {
+        checkpoint = std::make_unique<Checkpoint>();
+    }
+
+    checkpoint->indexCounter = indexCounter;
+    checkpoint->entityComponentMasks = entityComponentMasks;
+    checkpoint->entityVersions = entityVersions;
+    checkpoint->freeIds = freeIds;
+
+    for (BasePool* pool : componentPools)
+    {
+        if (pool)
+        {
+            pool->beginCheckpoint();
+        }
+    }
+}
+
+void EntityManager::restoreCheckpoint()
+{
+    assert(checkpoint && "EntityManager ~ restoreCheckpoint() called without an active checkpoint");
+
+    for (BasePool* pool : componentPools)
+    {
+        if (pool)
+        {
+            pool->restoreCheckpoint();
+        }
+    }
+
+    // Assigning keeps the capacity of the live tables, so this is a plain copy
+    // once the tables have grown to their working size.
+    indexCounter = checkpoint->indexCounter;
+    entityComponentMasks = checkpoint->entityComponentMasks;
+    entityVersions = checkpoint->entityVersions;
+    freeIds = checkpoint->freeIds;
+
+    // Cheaper to refile everything than to work out what the restore moved
+    for (BasePool* pool : componentPools)
+    {
+        if (pool)
+        {
+            pool->clearChanges();
+        }
+    }
+
+    for (const std::unique_ptr<BaseComponentIndex>& index : componentIndexes)
+    {
+        index->rebuild();
+    }
+}
+
+void EntityManager::endCheckpoint()
+{
+    if (!checkpoint)
+    {
+        return;
+    }
+
+    for (BasePool* pool : componentPools)
+    {
+        if (pool)
+        {
+            pool->endCheckpoint();
+        }
+    }
+
+    checkpoint.reset();
+}
+
+void EntityManager::releaseShared(size_t family, uint32_t index)
+{
+    if (family < sharedStores.size() && sharedStores[family])
+    {
+        sharedStores[family]->releaseEntity(*componentPools[family], index);
+    }
+}
+
+void EntityManager::indexComponentAdded(size_t family, uint32_t index)
+{
+    for (const std::unique_ptr<BaseComponentIndex>& componentIndex : componentIndexes)
+    {
+        if (componentIndex->componentFamily() == family)
+        {
+            componentIndex->componentAdded(index);
+        }
+    }
+}
+
+void EntityManager::indexComponentRemoved(size_t family, uint32_t index)
+{
+    for (const std::unique_ptr<BaseComponentIndex>& componentIndex : componentIndexes)
+    {
+        if (componentIndex->componentFamily() == family)
+        {
+            componentIndex->componentRemoved(index);
+        }
+    }
+}
+
+void EntityManager::flushComponentChanges(size_t family)
+{
+    BasePool* pool = componentPools[family];
+    if (pool->changes().empty())
+    {
+        return;
+    }
+
+    for (uint32_t index : pool->changes())
+    {
+        // Components removed since the write are already out of the index
+        if (!entityComponentMasks[index].test(family))
+        {
+            continue;
+        }
+
+        for (const std::unique_ptr<BaseComponentIndex>& componentIndex : componentIndexes)
+        {
+            if (componentIndex->componentFamily() == family)
+            {
+                componentIndex->componentChanged(index);
+            }
+        }
+    }
+
+    pool->clearChanges();
+}
+
+void EntityManager::touchForStructuralChange(BasePool* pool, uint32_t index)
+{
+    assert((!checkpoint || pool->isRestorable()) && "EntityManager ~ Component can't be rolled back, see BitwiseRestorable");
+
+    pool->touch(index);
+}
+
 EntityManager::DebugView EntityManager::entitiesForDebugging()
 {
     return DebugView(this);
@@ -114,7 +387,7 @@ void EntityManager::assertValidId(Entity::Id id) const
 
 std::vector<EntityManager::ComponentMask> EntityManager::allComponentMasks() const
 {
-    return entityComponentMasks;
+    return std::vector<ComponentMask>(entityComponentMasks.begin(), entityComponentMasks.end());
 }
 
 EntityManager::ComponentMask EntityManager::componentMask(Entity::Id id)
@@ -124,6 +397,55 @@ EntityManager::ComponentMask EntityManager::componentMask(Entity::Id id)
     return entityComponentMasks.at(id.index());
 }
 
+uint32_t EntityManager::prefetchComponents(const ComponentMask& mask, uint32_t index) const
+{
+    size_t nextIndex = ~0U;
+    for (size_t i = 0; i < componentPools.size(); ++i)
+    {
+        const BasePool* pool = componentPools[i];
+        if (pool && mask.test(i))
+        {
+            const size_t chunkSize = pool->elementsPerChunk();
+            const size_t nextChunk = (index / chunkSize + 1) * chunkSize;
+
+            pool->prefetch(nextChunk);
+            nextIndex = std::min(nextIndex, nextChunk);
+        }
+    }
+
+    // The masks are read for every index, keep them ahead as well
+    if (nextIndex < entityComponentMasks.size())
+    {
+        const size_t count = std::min<size_t>(entityComponentMasks.size(), nextIndex + (nextIndex - index)) - nextIndex;
+        storage->willNeed(entityComponentMasks.data() + nextIndex, count * sizeof(ComponentMask));
+    }
+
+    return static_cast<uint32_t>(nextIndex);
+}
+
+BasePool* EntityManager::accomodateComponent(const RuntimeComponentType& type)
+{
+    const BaseComponent::Family family = type.family();
+    if (componentPools.size() <= family)
+    {
+        componentPools.resize(family + 1, nullptr);
+    }
+
+    if (!componentPools[family])
+    {
+        BasePool* pool = new BytePool(type.size(), storage);
+        pool->expand(indexCounter);
+        componentPools[family] = pool;
+
+        if (checkpoint)
+        {
+            pool->beginCheckpoint();
+        }
+    }
+
+    return componentPools[family];
+}
+
 void EntityManager::accomodateComponent(uint32_t index)
 {
     if (entityComponentMasks.size() <= index)
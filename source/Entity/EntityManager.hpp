@@ -10,12 +10,19 @@
 #include <iterator>
 #include <algorithm>
 #include <tuple>
+#include <memory>
+#include <memory_resource>
 
 #include "Helpers/MemoryPool.hpp"
+#include "Helpers/ChunkStorage.hpp"
+#include "Helpers/TraceZones.hpp"
 #include "Entity.hpp"
+#include "ComponentIndex.hpp"
 #include "EventManagement/EventManager.hpp"
 #include "Components/Component.hpp"
+#include "Components/SharedComponent.hpp"
 
+class RuntimeComponentType;
 
 class EntityManager : private sf::NonCopyable
 {
@@ -53,10 +60,11 @@ class EntityManager : private sf::NonCopyable
                     , idIndex(index)
                     , capacity(entityManager->capacity())
                     , freeCursor(~0UL)
+                    , prefetchIndex(entityManager->storage->isPaged() ? 0 : ~0U)
                 {
                     if (All)
                     {
-                        std::sort(entityManager->freeIds.begin(), entityManager.freeIds.end()); //-V539
+                        std::sort(entityManager->freeIds.begin(), entityManager->freeIds.end()); //-V539
                         freeCursor = 0;
                     }
                 }
@@ -67,6 +75,7 @@ class EntityManager : private sf::NonCopyable
                     , idIndex(index)
                     , capacity(entityManager->capacity())
                     , freeCursor(~0UL)
+                    , prefetchIndex(entityManager->storage->isPaged() ? 0 : ~0U)
                 {
                     if (All)
                     {
@@ -84,8 +93,13 @@ class EntityManager : private sf::NonCopyable
 
                     if (idIndex < capacity)
                     {
-                        Entity entity = entityManager->getEntity(entityManager->createEntityId(idIndex));
-                        static_cast<Delegate*>(this)->nextEntity(entity);
+                        // Paged storage only, ask for the upcoming chunks before we get to them
+                        if (idIndex >= prefetchIndex)
+                        {
+                            prefetchIndex = entityManager->prefetchComponents(compMask, idIndex);
+                        }
+
+                        static_cast<Delegate*>(this)->nextEntity(entityManager->createEntityId(idIndex));
                     }
                 }
 
@@ -114,6 +128,7 @@ class EntityManager : private sf::NonCopyable
                 uint32_t idIndex;
                 size_t capacity;
                 size_t freeCursor;
+                uint32_t prefetchIndex;
         };
 
         template <bool All>
@@ -131,7 +146,7 @@ class EntityManager : private sf::NonCopyable
                             ViewIterator<Iterator, All>::next();
                         }
 
-                        void nextEntity(Entity& entity) {}
+                        void nextEntity(Entity::Id id) {}
                 };
 
                 Iterator begin() { return Iterator(entityManager, compMask, 0); }
@@ -161,6 +176,44 @@ class EntityManager : private sf::NonCopyable
         typedef BaseView<false> View;
         typedef BaseView<true> DebugView;
 
+        // Same as View but yields bare Entity::Id's instead of building an Entity
+        // for every step. Use it when filling EntityHandle arrays or anywhere the
+        // EntityManager pointer carried by Entity is not needed.
+        class IdView
+        {
+            public:
+                class Iterator : public ViewIterator<Iterator>
+                {
+                    public:
+                        Iterator(EntityManager* manager,
+                                const EntityManager::ComponentMask mask,
+                                uint32_t index)
+                            : ViewIterator<Iterator>(manager, mask, index)
+                        {
+                            ViewIterator<Iterator>::next();
+                        }
+
+                        Entity::Id operator*() const { return this->entityManager->createEntityId(this->idIndex); }
+
+                        void nextEntity(Entity::Id id) {}
+                };
+
+                Iterator begin() const { return Iterator(entityManager, compMask, 0); }
+                Iterator end() const { return Iterator(entityManager, compMask, static_cast<uint32_t>(entityManager->capacity())); }
+
+            private:
+                friend class EntityManager;
+
+                IdView(EntityManager* manager, EntityManager::ComponentMask mask)
+                    : entityManager(manager)
+                    , compMask(mask)
+                {}
+
+            private:
+                EntityManager* entityManager;
+                EntityManager::ComponentMask compMask;
+        };
+
         template <typename ... Components>
         class UnpackingView
         {
@@ -173,23 +226,23 @@ class EntityManager : private sf::NonCopyable
                             , compPtrs(std::tuple<ComponentPtr<Components>& ...>(ptrs...))
                         {}
 
-                        void unpack(const Entity& entity) const
+                        void unpack(Entity::Id id) const
                         {
-                            unpackImpl<0, Components...>(entity);
+                            unpackImpl<0, Components...>(id);
                         }
 
                     private:
                         template <int N, typename CompType>
-                        void unpackImpl(Entity entity) const
+                        void unpackImpl(Entity::Id id) const
                         {
-                            std::get<N>(compPtrs) = eManager->getComponent<CompType>(entity.id());
+                            std::get<N>(compPtrs) = eManager->getComponent<CompType>(id);
                         }
 
                         template <int N, typename Comp1, typename Comp2, typename ... CompN>
-                        void unpackImpl(Entity entity) const
+                        void unpackImpl(Entity::Id id) const
                         {
-                            std::get<N>(compPtrs) = eManager->getComponent<Comp1>(entity.id());
-                            unpackImpl<N + 1, Comp2, CompN...>(entity);
+                            std::get<N>(compPtrs) = eManager->getComponent<Comp1>(id);
+                            unpackImpl<N + 1, Comp2, CompN...>(id);
                         }
 
                     private:
@@ -210,9 +263,9 @@ class EntityManager : private sf::NonCopyable
                             ViewIterator<Iterator>::next();
                         }
 
-                        void nextEntity(Entity& entity)
+                        void nextEntity(Entity::Id id)
                         {
-                            unpacker.unpack(entity);
+                            unpacker.unpack(id);
                         }
 
                     private:
@@ -241,7 +294,9 @@ class EntityManager : private sf::NonCopyable
         };
 
     public:
-        explicit EntityManager(EventManager& eventManager);
+        // Storage holds the component pools and entity tables, nullptr keeps them on the
+        // heap. See MappedChunkStorage for running simulations bigger than RAM.
+        explicit EntityManager(EventManager& eventManager, ChunkStorage* storage = nullptr);
         ~EntityManager();
 
         // Entity Management
@@ -251,11 +306,39 @@ class EntityManager : private sf::NonCopyable
         Entity getEntity(Entity::Id entityId);
         bool validEntity(Entity::Id id) const;
 
+        // Compact handle support, resolve() returns Entity::INVALID_ID for stale handles.
+        template <unsigned IndexBits>
+        bool validEntity(BasicEntityHandle<IndexBits> handle) const;
+
+        template <unsigned IndexBits>
+        Entity::Id resolve(BasicEntityHandle<IndexBits> handle) const;
+
         // Container Management
         void reset();
         size_t size() const { return entityComponentMasks.size() - freeIds.size(); }
         size_t capacity() const { return entityComponentMasks.size(); }
 
+        // Storage Maintenance
+        // Swaps the storage slots of two live entities, moving all of their components.
+        // Both entities get new Ids, the old ones (and handles/ComponentRefs taken from them)
+        // go stale. An EntityMovedEvent is emitted for each so stored ids can be patched.
+        void swapEntities(Entity::Id first, Entity::Id second);
+
+        // Rollback Checkpoints
+        // beginCheckpoint() snapshots the entity tables and starts tracking component
+        // writes. Only the pool segments written afterwards are saved (copy on first write),
+        // restoreCheckpoint() copies them and the entity tables back in bulk. A checkpoint
+        // can be restored any number of times until endCheckpoint().
+        //
+        // NOTE: Restoring does not emit any events. Writes are tracked through ComponentPtr,
+        // ComponentRef and the assign/remove/destroy calls. Pools of components that are not
+        // BitwiseRestorable are left as they are, so don't assign, remove or destroy those
+        // while a checkpoint is active.
+        void beginCheckpoint();
+        void restoreCheckpoint();
+        void endCheckpoint();
+        bool hasCheckpoint() const { return checkpoint != nullptr; }
+
         // Entity Component Management
         template <typename CompType>
         static size_t componentFamily();
@@ -275,6 +358,9 @@ class EntityManager : private sf::NonCopyable
         template <typename CompType, typename = std::enable_if_t<std::is_const<CompType>::value>>
         const ComponentPtr<CompType, const EntityManager> getComponent(Entity::Id id) const;
 
+        template <typename CompType>
+        ComponentRef<CompType> getComponentRef(Entity::Id id);
+
         template <typename ... Components>
         std::tuple<ComponentPtr<Components>...> getComponents(const Entity::Id id);
 
@@ -288,6 +374,58 @@ class EntityManager : private sf::NonCopyable
         template <typename ... Components>
         UnpackingView<Components...> getEntitiesWithComponents(ComponentPtr<Components>& ... components);
 
+        template <typename ... Components>
+        IdView getEntityIdsWithComponents();
+
+        // Runtime Component Management (see Components/RuntimeComponent.hpp)
+        // The data is zero filled, or copied from initial. No ComponentAdded/RemovedEvents are
+        // emitted for runtime types, there is no compile time type to emit them with.
+        void* assignComponent(Entity::Id id, const RuntimeComponentType& type, const void* initial = nullptr);
+        void removeComponent(Entity::Id id, const RuntimeComponentType& type);
+        bool hasComponent(Entity::Id id, const RuntimeComponentType& type) const;
+        void* getComponent(Entity::Id id, const RuntimeComponentType& type);
+        const void* getComponent(Entity::Id id, const RuntimeComponentType& type) const;
+
+        // Same as above with runtime types in the query, pass the combined RuntimeComponentType::mask()'s
+        template <typename ... Components>
+        BaseView<false> getEntitiesWithComponents(const ComponentMask& runtimeMask);
+
+        template <typename ... Components>
+        IdView getEntityIdsWithComponents(const ComponentMask& runtimeMask);
+
+        // Shared Components (see Components/SharedComponent.hpp)
+        // Assigning and removing SharedComponent<CompType> goes through the regular
+        // assignComponent/removeComponent, which keep the refcounts up to date.
+        template <typename CompType, typename ... Args>
+        SharedComponent<CompType> createSharedComponent(Args&& ... args);
+
+        template <typename CompType>
+        void releaseSharedComponent(SharedComponent<CompType> shared);
+
+        template <typename CompType>
+        CompType& getSharedComponent(SharedComponent<CompType> shared);
+
+        template <typename CompType>
+        CompType* getSharedComponent(Entity::Id id);
+
+        template <typename CompType>
+        SharedComponentStore<CompType>& sharedComponentStore();
+
+        // Entities with SharedComponent<CompType> and all of Components, grouped so every
+        // entity referencing the same value comes out contiguously. The groups point into
+        // scratch memory of the store and are valid until the next call for CompType.
+        template <typename CompType, typename ... Components>
+        const std::vector<SharedComponentGroup<CompType>>& getEntitiesGroupedBy();
+
+        // Secondary Indexes (see Entity/ComponentIndex.hpp)
+        // Lookups of the entities whose CompType projects to a key, e.g. a behaviour flag or a
+        // team id, instead of scanning the whole pool. The index is owned by the manager.
+        template <typename CompType, typename Projection>
+        HashIndex<CompType, ProjectedKey<CompType, Projection>>& createHashIndex(Projection projection);
+
+        template <typename CompType, typename Projection>
+        SortedIndex<CompType, ProjectedKey<CompType, Projection>>& createSortedIndex(Projection projection);
+
         template <typename CompType>
         void unpack(Entity::Id id, ComponentPtr<CompType>& outputParam);
 
@@ -298,6 +436,9 @@ class EntityManager : private sf::NonCopyable
         BaseView<true> entitiesForDebugging();
         void assertValidId(Entity::Id id) const;
 
+        // Version of the entity stored at index, 0 if the index has never been handed out.
+        uint32_t entityVersion(uint32_t index) const { return index < entityVersions.size() ? entityVersions[index] : 0; }
+
         template <typename CompType>
         CompType* getComponentPtr(Entity::Id id);
 
@@ -325,20 +466,67 @@ class EntityManager : private sf::NonCopyable
         template <typename CompType>
         Pool<CompType>* accomodateComponent();
 
+        BasePool* accomodateComponent(const RuntimeComponentType& type);
+
+        // Static component mask of Components, empty if there are none
+        template <typename ... Components>
+        ComponentMask staticComponentMask();
+
+        // Prefetches the chunk after the one holding index for every pool in mask,
+        // returns the index at which the views should call this again.
+        uint32_t prefetchComponents(const ComponentMask& mask, uint32_t index) const;
+
+        // Called before a component is constructed in or destroyed from pool
+        void touchForStructuralChange(BasePool* pool, uint32_t index);
+
+        // Drops the shared value reference of the entity, if family is a SharedComponent
+        void releaseShared(size_t family, uint32_t index);
+
+        template <class Index, typename Projection>
+        Index& createIndex(Projection projection);
+
+        // Index hooks, all of them are a no-op while there are no indexes
+        void indexComponentAdded(size_t family, uint32_t index);
+        void indexComponentRemoved(size_t family, uint32_t index);
+
+        // Re-projects the components of family written since the last flush
+        void flushComponentChanges(size_t family);
+
     private:
         friend class Entity;
 
         template <typename CompType, typename EManager>
         friend class ComponentPtr;
 
+        template <typename CompType, typename EManager>
+        friend class ComponentRef;
+
+        friend class StateDeltaEncoder;
+
+        template <typename CompType, typename Key, typename Buckets, class EManager>
+        friend class ComponentIndex;
+
         uint32_t indexCounter = 0;
 
         EventManager& eventManager;
+        ChunkStorage* storage;
 
         std::vector<BasePool*> componentPools;
-        std::vector<ComponentMask> entityComponentMasks;
-        std::vector<uint32_t> entityVersions;
+        std::vector<BaseSharedComponentStore*> sharedStores; // Indexed by the family of SharedComponent<T>
+        std::vector<std::unique_ptr<BaseComponentIndex>> componentIndexes;
+        std::pmr::vector<ComponentMask> entityComponentMasks;
+        std::pmr::vector<uint32_t> entityVersions;
         std::vector<uint32_t> freeIds;
+
+        struct Checkpoint
+        {
+            uint32_t indexCounter;
+            std::pmr::vector<ComponentMask> entityComponentMasks;
+            std::pmr::vector<uint32_t> entityVersions;
+            std::vector<uint32_t> freeIds;
+        };
+
+        std::unique_ptr<Checkpoint> checkpoint;
 };
 
 #include "EntityManager.inl"
\ No newline at end of file
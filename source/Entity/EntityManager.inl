@@ -3,6 +3,24 @@
 #include "Components/Component.hpp"
 #include "EventManagement/Events/ComponentEvents.hpp"
 
+template <unsigned IndexBits>
+bool EntityManager::validEntity(BasicEntityHandle<IndexBits> handle) const
+{
+    return handle.index() < entityVersions.size() &&
+           handle.matches(entityVersions[handle.index()]);
+}
+
+template <unsigned IndexBits>
+Entity::Id EntityManager::resolve(BasicEntityHandle<IndexBits> handle) const
+{
+    if (!validEntity(handle))
+    {
+        return Entity::INVALID_ID;
+    }
+
+    return createEntityId(handle.index());
+}
+
 template <typename CompType>
 size_t EntityManager::componentFamily()
 {
@@ -19,10 +37,17 @@ ComponentPtr<CompType> EntityManager::assignComponent(Entity::Id id, Args&& ...
 
     // Add it into a memory pool for the component family
     Pool<CompType>* pool = accomodateComponent<CompType>();
+    touchForStructuralChange(pool, id.index());
     new(pool->get(id.index())) CompType(std::forward<Args>(args) ...);
 
     // Set the bit for the component
     entityComponentMasks[id.index()].set(family);
+    indexComponentAdded(family, id.index());
+
+    if constexpr (IsSharedComponent<CompType>::value)
+    {
+        sharedComponentStore<typename IsSharedComponent<CompType>::ValueType>().addRef(static_cast<CompType*>(pool->get(id.index()))->index);
+    }
 
     // Create the component
     ComponentPtr<CompType> component(this, id);
@@ -43,7 +68,10 @@ void EntityManager::removeComponent(Entity::Id id)
     ComponentPtr<CompType> component(this, id);
     eventManager.emit<ComponentRemovedEvent<CompType>>(Entity(this, id), component);
 
+    indexComponentRemoved(family, index);
     entityComponentMasks[id.index()].reset(family);
+    releaseShared(family, index);
+    touchForStructuralChange(pool, index);
     pool->destroy(index);
 }
 
@@ -107,6 +135,17 @@ const ComponentPtr<CompType, const EntityManager> EntityManager::getComponent(En
     return ComponentPtr<CompType, const EntityManager>(this, id);
 }
 
+template <typename CompType>
+ComponentRef<CompType> EntityManager::getComponentRef(Entity::Id id)
+{
+    if (!hasComponent<CompType>(id))
+    {
+        return ComponentRef<CompType>();
+    }
+
+    return ComponentRef<CompType>(this, id, getComponentPtr<CompType>(id), componentPools[componentFamily<CompType>()]);
+}
+
 template <typename ... Components>
 std::tuple<ComponentPtr<Components>...> EntityManager::getComponents(Entity::Id id)
 {
@@ -135,6 +174,160 @@ EntityManager::UnpackingView<Components...> EntityManager::getEntitiesWithCompon
     return UnpackingView<Components...>(this, compMask, components...);
 }
 
+template <typename ... Components>
+EntityManager::IdView EntityManager::getEntityIdsWithComponents()
+{
+    auto compMask = componentMask<Components...>();
+
+    return IdView(this, compMask);
+}
+
+template <typename ... Components>
+EntityManager::View EntityManager::getEntitiesWithComponents(const ComponentMask& runtimeMask)
+{
+    return View(this, staticComponentMask<Components...>() | runtimeMask);
+}
+
+template <typename ... Components>
+EntityManager::IdView EntityManager::getEntityIdsWithComponents(const ComponentMask& runtimeMask)
+{
+    return IdView(this, staticComponentMask<Components...>() | runtimeMask);
+}
+
+template <typename CompType, typename ... Args>
+SharedComponent<CompType> EntityManager::createSharedComponent(Args&& ... args)
+{
+    return SharedComponent<CompType>(sharedComponentStore<CompType>().create(std::forward<Args>(args)...));
+}
+
+template <typename CompType>
+void EntityManager::releaseSharedComponent(SharedComponent<CompType> shared)
+{
+    sharedComponentStore<CompType>().release(shared.index);
+}
+
+template <typename CompType>
+CompType& EntityManager::getSharedComponent(SharedComponent<CompType> shared)
+{
+    return sharedComponentStore<CompType>().get(shared.index);
+}
+
+template <typename CompType>
+CompType* EntityManager::getSharedComponent(Entity::Id id)
+{
+    if (!hasComponent<SharedComponent<CompType>>(id))
+    {
+        return nullptr;
+    }
+
+    const BasePool* pool = componentPools[componentFamily<SharedComponent<CompType>>()];
+    const SharedComponent<CompType>* shared = static_cast<const SharedComponent<CompType>*>(pool->get(id.index()));
+
+    return &sharedComponentStore<CompType>().get(shared->index);
+}
+
+template <typename CompType>
+SharedComponentStore<CompType>& EntityManager::sharedComponentStore()
+{
+    const BaseComponent::Family family = componentFamily<SharedComponent<CompType>>();
+    if (sharedStores.size() <= family)
+    {
+        sharedStores.resize(family + 1, nullptr);
+    }
+
+    if (!sharedStores[family])
+    {
+        sharedStores[family] = new SharedComponentStore<CompType>();
+    }
+
+    return *static_cast<SharedComponentStore<CompType>*>(sharedStores[family]);
+}
+
+template <typename CompType, typename ... Components>
+const std::vector<SharedComponentGroup<CompType>>& EntityManager::getEntitiesGroupedBy()
+{
+    TRACE_SCOPE("EntityManager::getEntitiesGroupedBy");
+
+    SharedComponentStore<CompType>& store = sharedComponentStore<CompType>();
+    store.groups.clear();
+
+    const BaseComponent::Family family = componentFamily<SharedComponent<CompType>>();
+    if (family >= componentPools.size() || !componentPools[family])
+    {
+        return store.groups;
+    }
+
+    // Counting sort on the shared index, one pass to collect and count, one to place
+    const BasePool* pool = componentPools[family];
+    store.groupScratch.clear();
+    store.groupOffsets.assign(store.capacity() + 1, 0);
+
+    for (Entity::Id id : getEntityIdsWithComponents<SharedComponent<CompType>, Components...>())
+    {
+        const uint32_t sharedIndex = static_cast<const SharedComponent<CompType>*>(pool->get(id.index()))->index;
+        store.groupScratch.emplace_back(sharedIndex, id);
+        store.groupOffsets[sharedIndex + 1]++;
+    }
+
+    for (size_t i = 1; i < store.groupOffsets.size(); ++i)
+    {
+        store.groupOffsets[i] += store.groupOffsets[i - 1];
+    }
+
+    store.groupedIds.resize(store.groupScratch.size());
+    for (const auto& [sharedIndex, id] : store.groupScratch)
+    {
+        store.groupedIds[store.groupOffsets[sharedIndex]++] = id;
+    }
+
+    // groupOffsets[i] now holds the end of group i, which is also the start of group i + 1
+    uint32_t start = 0;
+    for (uint32_t sharedIndex = 0; sharedIndex < store.capacity(); ++sharedIndex)
+    {
+        const uint32_t end = store.groupOffsets[sharedIndex];
+        if (end != start)
+        {
+            const Entity::Id* ids = store.groupedIds.data();
+            store.groups.push_back({ SharedComponent<CompType>(sharedIndex), &store.get(sharedIndex), ids + start, ids + end });
+        }
+
+        start = end;
+    }
+
+    return store.groups;
+}
+
+template <typename CompType, typename Projection>
+HashIndex<CompType, ProjectedKey<CompType, Projection>>& EntityManager::createHashIndex(Projection projection)
+{
+    return createIndex<HashIndex<CompType, ProjectedKey<CompType, Projection>>>(std::move(projection));
+}
+
+template <typename CompType, typename Projection>
+SortedIndex<CompType, ProjectedKey<CompType, Projection>>& EntityManager::createSortedIndex(Projection projection)
+{
+    return createIndex<SortedIndex<CompType, ProjectedKey<CompType, Projection>>>(std::move(projection));
+}
+
+template <class Index, typename Projection>
+Index& EntityManager::createIndex(Projection projection)
+{
+    const BaseComponent::Family family = componentFamily<typename Index::ComponentType>();
+
+    // Writes are picked up through the pool, so make sure it exists and records them
+    BasePool* pool = accomodateComponent<typename Index::ComponentType>();
+    if (!pool->tracksChanges())
+    {
+        pool->trackChanges();
+    }
+
+    Index* index = new Index(this, family, pool, std::move(projection));
+    componentIndexes.emplace_back(index);
+    index->rebuild();
+
+    return *index;
+}
+
 template <typename CompType>
 void EntityManager::unpack(Entity::Id id, ComponentPtr<CompType>& outputParam)
 {
@@ -160,6 +353,9 @@ CompType* EntityManager::getComponentPtr(Entity::Id id)
     BasePool* pool = componentPools[componentFamily<CompType>()];
     assert(pool);
 
+    // Handing out a mutable pointer counts as a write for checkpoints
+    pool->touch(id.index());
+
     return static_cast<CompType*>(pool->get(id.index()));
 }
 
@@ -189,6 +385,19 @@ EntityManager::ComponentMask EntityManager::componentMask()
     return componentMask<CompType1>() | componentMask<CompType2, CompTypeArgs...>();
 }
 
+template <typename ... Components>
+EntityManager::ComponentMask EntityManager::staticComponentMask()
+{
+    if constexpr (sizeof...(Components) == 0)
+    {
+        return ComponentMask();
+    }
+    else
+    {
+        return componentMask<Components...>();
+    }
+}
+
 template <typename CompType>
 EntityManager::ComponentMask EntityManager::componentMask(const ComponentPtr<CompType>& comp)
 {
@@ -212,9 +421,14 @@ Pool<CompType>* EntityManager::accomodateComponent()
 
     if (!componentPools[family])
     {
-        Pool<CompType>* pool = new Pool<CompType>();
+        Pool<CompType>* pool = new Pool<CompType>(storage);
         pool->expand(indexCounter);
         componentPools[family] = pool;
+
+        if (checkpoint)
+        {
+            pool->beginCheckpoint();
+        }
     }
 
     return static_cast<Pool<CompType>*>(componentPools[family]);
@@ -0,0 +1,313 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <concepts>
+
+#include "Entity/Entity.hpp"
+#include "EventDispatcher.hpp"
+
+// Tells EventManager which entity an event is about, for receivers subscribed to a single
+// entity. Events with an `Entity entity` member work out of the box, specialize this for
+// anything else:
+//
+//      template <>
+//      struct EventEntity<HitEvent> { static Entity::Id get(const HitEvent& event) { return event.target; } };
+template <typename EventType, typename = void>
+struct EventEntity {};
+
+template <typename EventType>
+struct EventEntity<EventType, std::void_t<decltype(std::declval<const EventType&>().entity.id())>>
+{
+    static Entity::Id get(const EventType& event) { return event.entity.id(); }
+};
+
+template <typename EventType>
+concept RoutableEvent = requires(const EventType& event)
+{
+    { EventEntity<EventType>::get(event) } -> std::convertible_to<Entity::Id>;
+};
+
+// Receivers of an event family keyed by entity, the entity scoped counterpart of EventDispatcher.
+// An emit only looks up the receivers of the entity the event is about, so watching a handful
+// of entities costs one hash lookup per event instead of every watcher filtering every event.
+//
+// NOTE: Routes are keyed by the full Entity::Id, version included. Whoever gives a live entity a
+// new id (EntityManager::swapEntities) has to moveEntity() its routes along, otherwise the
+// receivers stop getting its events and dropEntity() never finds them once it is destroyed.
+// Events that still carry the old id (queued before the move) only arrive through aliasEntity().
+class EntityEventRouter
+{
+    public:
+        using Thunk = EventDispatcher::Thunk;
+        using Delegate = EventDispatcher::Delegate;
+
+        void connect(std::size_t family, Entity::Id entity, void* receiver, Thunk thunk)
+        {
+            if (family >= routeCounts.size())
+            {
+                routeCounts.resize(family + 1, 0);
+            }
+
+            routes[Key{ family, entity.getId() }].push_back({ receiver, thunk });
+            ++routeCounts[family];
+        }
+
+        bool disconnect(std::size_t family, Entity::Id entity, void* receiver)
+        {
+            auto route = routes.find(Key{ family, entity.getId() });
+            if (route == routes.end())
+            {
+                return false;
+            }
+
+            std::vector<Delegate>& delegates = route->second;
+            auto it = std::find_if(delegates.begin(), delegates.end(), [receiver](const Delegate& delegate) { return delegate.receiver == receiver; });
+            if (it == delegates.end())
+            {
+                return false;
+            }
+
+            it->receiver = nullptr;
+            --routeCounts[family];
+            removeHoles(route);
+
+            return true;
+        }
+
+        // Forgets every receiver of entity, called once the entity is destroyed
+        void dropEntity(Entity::Id entity)
+        {
+            for (std::size_t family = 0; family < routeCounts.size(); ++family)
+            {
+                if (routeCounts[family] == 0)
+                {
+                    continue;
+                }
+
+                auto route = routes.find(Key{ family, entity.getId() });
+                if (route != routes.end())
+                {
+                    for (Delegate& delegate : route->second)
+                    {
+                        if (delegate.receiver)
+                        {
+                            delegate.receiver = nullptr;
+                            --routeCounts[family];
+                        }
+                    }
+
+                    removeHoles(route);
+                }
+            }
+        }
+
+        // Rekeys every receiver of from to to, before anything is emitted about the new id
+        void moveEntity(Entity::Id from, Entity::Id to)
+        {
+            if (from == to)
+            {
+                return;
+            }
+
+            for (std::size_t family = 0; family < routeCounts.size(); ++family)
+            {
+                if (routeCounts[family] == 0)
+                {
+                    continue;
+                }
+
+                // Moving the node keeps the delegate list in place for an emit running on it
+                RouteMap::node_type route = routes.extract(Key{ family, from.getId() });
+                if (route.empty())
+                {
+                    continue;
+                }
+
+                route.key().entity = to.getId();
+                routesMoved = true;
+
+                RouteMap::insert_return_type result = routes.insert(std::move(route));
+                if (!result.inserted)
+                {
+                    // to had receivers of its own already, only possible for ids that never belonged to a live entity
+                    std::vector<Delegate>& delegates = result.position->second;
+                    delegates.insert(delegates.end(), result.node.mapped().begin(), result.node.mapped().end());
+                }
+
+                for (Key& key : pendingCleanup)
+                {
+                    if (key == Key{ family, from.getId() })
+                    {
+                        key.entity = to.getId();
+                    }
+                }
+            }
+        }
+
+        // Events still naming from go to the receivers of to until forgetAlias(from), for events
+        // that were already queued when the entity moved
+        void aliasEntity(Entity::Id from, Entity::Id to) { aliases[from.getId()] = to.getId(); }
+        void forgetAlias(Entity::Id from) { aliases.erase(from.getId()); }
+
+        // Forgets receiver on every entity. Routes that moved are keyed by ids the receiver never
+        // subscribed with, so a receiver going away sweeps the routes once any have moved.
+        void disconnectReceiver(const void* receiver)
+        {
+            for (auto route = routes.begin(); route != routes.end();)
+            {
+                auto current = route++;
+
+                bool found = false;
+                for (Delegate& delegate : current->second)
+                {
+                    if (delegate.receiver == receiver)
+                    {
+                        delegate.receiver = nullptr;
+                        --routeCounts[current->first.family];
+                        found = true;
+                    }
+                }
+
+                if (found)
+                {
+                    removeHoles(current);
+                }
+            }
+        }
+
+        bool hasMovedRoutes() const { return routesMoved; }
+
+        bool isConnected(std::size_t family, Entity::Id entity, const void* receiver) const
+        {
+            auto route = routes.find(Key{ family, entity.getId() });
+
+            return route != routes.end() && std::any_of(route->second.begin(), route->second.end(), [receiver](const Delegate& delegate) { return delegate.receiver == receiver; });
+        }
+
+        bool hasRoutes(std::size_t family) const
+        {
+            return family < routeCounts.size() && routeCounts[family] > 0;
+        }
+
+        void emit(std::size_t family, Entity::Id entity, const void* event)
+        {
+            auto route = routes.find(Key{ family, entity.getId() });
+            if (route == routes.end() && !aliases.empty())
+            {
+                route = findAliasedRoute(family, entity.getId());
+            }
+
+            if (route == routes.end())
+            {
+                return;
+            }
+
+            // The map is node based, so the list stays put while receivers add routes. Removed
+            // receivers are only cleared out and compacted once no emit is running.
+            std::vector<Delegate>& delegates = route->second;
+            const std::size_t count = delegates.size();
+            ++emitting;
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const Delegate delegate = delegates[i];
+                if (delegate.receiver)
+                {
+                    delegate.thunk(delegate.receiver, event);
+                }
+            }
+
+            if (--emitting == 0 && !pendingCleanup.empty())
+            {
+                cleanup();
+            }
+        }
+
+        std::size_t size() const
+        {
+            std::size_t total = 0;
+            for (std::size_t count : routeCounts)
+            {
+                total += count;
+            }
+
+            return total;
+        }
+
+    private:
+        struct Key
+        {
+            std::size_t family;
+            std::uint64_t entity;
+
+            bool operator==(const Key& other) const { return family == other.family && entity == other.entity; }
+        };
+
+        struct KeyHash
+        {
+            std::size_t operator()(const Key& key) const
+            {
+                return std::hash<std::uint64_t>()(key.entity * 31 + key.family);
+            }
+        };
+
+        using RouteMap = std::unordered_map<Key, std::vector<Delegate>, KeyHash>;
+
+        void removeHoles(RouteMap::iterator route)
+        {
+            if (emitting > 0)
+            {
+                pendingCleanup.push_back(route->first);
+                return;
+            }
+
+            std::vector<Delegate>& delegates = route->second;
+            delegates.erase(std::remove_if(delegates.begin(), delegates.end(), [](const Delegate& delegate) { return delegate.receiver == nullptr; }), delegates.end());
+            if (delegates.empty())
+            {
+                routes.erase(route);
+            }
+        }
+
+        // Follows a stale id through every move since, to the route of the id the entity has now
+        RouteMap::iterator findAliasedRoute(std::size_t family, std::uint64_t entity)
+        {
+            auto route = routes.end();
+            for (auto alias = aliases.find(entity); alias != aliases.end() && route == routes.end(); alias = aliases.find(entity))
+            {
+                entity = alias->second;
+                route = routes.find(Key{ family, entity });
+            }
+
+            return route;
+        }
+
+        void cleanup()
+        {
+            std::vector<Key> keys;
+            keys.swap(pendingCleanup);
+
+            for (const Key& key : keys)
+            {
+                auto route = routes.find(key);
+                if (route != routes.end())
+                {
+                    removeHoles(route);
+                }
+            }
+        }
+
+    private:
+        RouteMap routes;
+        std::vector<std::size_t> routeCounts; // Live receivers per event family
+        std::vector<Key> pendingCleanup;
+        std::unordered_map<std::uint64_t, std::uint64_t> aliases; // Stale id to the id the entity moved to
+        std::uint32_t emitting = 0;
+        bool routesMoved = false;
+};
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <utility>
+
+class EventManager;
+
+struct EventChannelStats
+{
+    std::size_t capacity;
+    std::size_t depth;     // Events waiting to be drained
+    std::size_t highWater; // Deepest the channel has been at a drain since it was created
+    std::uint64_t sent;
+    std::uint64_t dropped; // send() calls that found the channel full
+};
+
+// Internal, type erased part of EventChannel used by EventManager
+class BaseEventChannel
+{
+    public:
+        virtual ~BaseEventChannel() {}
+
+        // Owning thread only, emits everything that was sent before the call
+        virtual std::size_t drain(EventManager& manager) = 0;
+        virtual EventChannelStats stats() const = 0;
+};
+
+// Bounded multi producer, single consumer queue of EventType (Dmitry Vyukov's bounded queue).
+// Any thread can send() without locking or allocating, the events are emitted on the thread
+// owning the EventManager when it calls EventManager::drainChannels(). Create channels
+// through EventManager::createChannel() before handing them to other threads.
+//
+// NOTE: A full channel drops the event and send() returns false, size the capacity for the
+// worst frame and keep an eye on stats().dropped.
+template <typename EventType, class EManager = EventManager>
+class EventChannel : public BaseEventChannel
+{
+    public:
+        // Capacity is rounded up to a power of two
+        explicit EventChannel(std::size_t requestedCapacity);
+        virtual ~EventChannel();
+
+        EventChannel(const EventChannel&) = delete;
+        EventChannel& operator=(const EventChannel&) = delete;
+
+        // Any thread
+        template <typename ... EventArgs>
+        bool send(EventArgs&& ... args);
+
+        virtual std::size_t drain(EventManager& manager) override;
+        virtual EventChannelStats stats() const override;
+
+    private:
+        struct Cell
+        {
+            std::atomic<std::size_t> sequence;
+            alignas(EventType) unsigned char storage[sizeof(EventType)];
+        };
+
+        static constexpr std::size_t CacheLine = 64;
+
+        // Pops the oldest event into callback, false if the next event isn't fully written yet
+        template <typename Callback>
+        bool receive(Callback&& callback);
+
+    private:
+        std::unique_ptr<Cell[]> cells;
+        std::size_t mask;
+
+        // Producers and the consumer write these, keep them on separate cache lines
+        alignas(CacheLine) std::atomic<std::size_t> enqueuePos;
+        alignas(CacheLine) std::atomic<std::size_t> dequeuePos;
+        alignas(CacheLine) std::atomic<std::uint64_t> droppedCount;
+        std::atomic<std::size_t> highWater;
+};
+
+template <typename EventType, class EManager>
+EventChannel<EventType, EManager>::EventChannel(std::size_t requestedCapacity)
+    : enqueuePos(0)
+    , dequeuePos(0)
+    , droppedCount(0)
+    , highWater(0)
+{
+    std::size_t capacity = 2;
+    while (capacity < requestedCapacity)
+    {
+        capacity *= 2;
+    }
+
+    cells.reset(new Cell[capacity]);
+    for (std::size_t i = 0; i < capacity; ++i)
+    {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    mask = capacity - 1;
+}
+
+template <typename EventType, class EManager>
+EventChannel<EventType, EManager>::~EventChannel()
+{
+    // Events that were never drained still need their destructor
+    while (receive([](const EventType&) {}))
+    {}
+}
+
+template <typename EventType, class EManager>
+template <typename ... EventArgs>
+bool EventChannel<EventType, EManager>::send(EventArgs&& ... args)
+{
+    Cell* cell;
+    std::size_t pos = enqueuePos.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+        cell = &cells[pos & mask];
+        const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const std::intptr_t difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+
+        if (difference == 0)
+        {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    new(cell->storage) EventType(std::forward<EventArgs>(args)...);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+
+    return true;
+}
+
+template <typename EventType, class EManager>
+std::size_t EventChannel<EventType, EManager>::drain(EventManager& manager)
+{
+    // Stop at what was sent before the call, producers can't keep the owner in here forever
+    const std::size_t end = enqueuePos.load(std::memory_order_acquire);
+    std::size_t drained = 0;
+
+    // Only drains take events out, so the channel is at its deepest right here. The consumer owns
+    // dequeuePos and it never passes a claimed slot, the difference can't wrap.
+    const std::size_t depth = end - dequeuePos.load(std::memory_order_relaxed);
+    if (depth > highWater.load(std::memory_order_relaxed))
+    {
+        highWater.store(depth, std::memory_order_relaxed);
+    }
+
+    while (dequeuePos.load(std::memory_order_relaxed) != end &&
+           receive([&manager](const EventType& event) { static_cast<EManager&>(manager).template emit<EventType>(event); }))
+    {
+        ++drained;
+    }
+
+    return drained;
+}
+
+template <typename EventType, class EManager>
+EventChannelStats EventChannel<EventType, EManager>::stats() const
+{
+    // dequeuePos first, the consumer may move on in between and a later dequeuePos could pass the enqueuePos read before it
+    const std::size_t dequeued = dequeuePos.load(std::memory_order_acquire);
+    const std::size_t enqueued = enqueuePos.load(std::memory_order_acquire);
+    const std::intptr_t depth = static_cast<std::intptr_t>(enqueued - dequeued);
+
+    EventChannelStats result;
+    result.capacity = mask + 1;
+    result.depth = depth > 0 ? static_cast<std::size_t>(depth) : 0;
+    result.highWater = highWater.load(std::memory_order_relaxed);
+    result.sent = enqueued;
+    result.dropped = droppedCount.load(std::memory_order_relaxed);
+
+    return result;
+}
+
+template <typename EventType, class EManager>
+template <typename Callback>
+bool EventChannel<EventType, EManager>::receive(Callback&& callback)
+{
+    const std::size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    Cell& cell = cells[pos & mask];
+
+    if (cell.sequence.load(std::memory_order_acquire) != pos + 1)
+    {
+        return false;
+    }
+
+    EventType* event = std::launder(reinterpret_cast<EventType*>(cell.storage));
+    callback(*event);
+    event->~EventType();
+
+    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+    dequeuePos.store(pos + 1, std::memory_order_relaxed);
+
+    return true;
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+// Flat per event family arrays of receivers used by EventManager. A delegate is the
+// receiver pointer plus a thunk calling its receive() member, so emitting is a loop over
+// contiguous memory with one direct call through a function pointer per receiver. No
+// heap nodes, no std::function and no reference counting on the emit path.
+//
+// Receivers may subscribe and unsubscribe while an event is emitted, removals during an
+// emit leave a hole that is compacted once the outermost emit of that family returns.
+class EventDispatcher
+{
+    public:
+        using Thunk = void (*)(void* receiver, const void* event);
+
+        struct Delegate
+        {
+            void* receiver;
+            Thunk thunk;
+        };
+
+        void connect(std::size_t family, void* receiver, Thunk thunk)
+        {
+            if (family >= lists.size())
+            {
+                lists.resize(family + 1);
+            }
+
+            lists[family].delegates.push_back({ receiver, thunk });
+        }
+
+        bool disconnect(std::size_t family, void* receiver)
+        {
+            if (family >= lists.size())
+            {
+                return false;
+            }
+
+            DelegateList& list = lists[family];
+            auto it = std::find_if(list.delegates.begin(), list.delegates.end(), [receiver](const Delegate& delegate) { return delegate.receiver == receiver; });
+            if (it == list.delegates.end())
+            {
+                return false;
+            }
+
+            if (list.emitting > 0)
+            {
+                it->receiver = nullptr;
+                list.holes = true;
+            }
+            else
+            {
+                list.delegates.erase(it);
+            }
+
+            return true;
+        }
+
+        inline void emit(std::size_t family, const void* event)
+        {
+            // Fast path, nobody is listening
+            if (family >= lists.size() || lists[family].delegates.empty())
+            {
+                return;
+            }
+
+            emitToReceivers(family, event);
+        }
+
+        bool hasReceivers(std::size_t family) const
+        {
+            return family < lists.size() && !lists[family].delegates.empty();
+        }
+
+        std::size_t size(std::size_t family) const
+        {
+            if (family >= lists.size())
+            {
+                return 0;
+            }
+
+            return std::count_if(lists[family].delegates.begin(), lists[family].delegates.end(), [](const Delegate& delegate) { return delegate.receiver != nullptr; });
+        }
+
+        std::size_t size() const
+        {
+            std::size_t total = 0;
+            for (std::size_t family = 0; family < lists.size(); ++family)
+            {
+                total += size(family);
+            }
+
+            return total;
+        }
+
+    private:
+        struct DelegateList
+        {
+            std::vector<Delegate> delegates;
+            std::uint32_t emitting = 0;
+            bool holes = false;
+        };
+
+        void emitToReceivers(std::size_t family, const void* event)
+        {
+            // Receivers subscribing to a new family can grow lists, so index it every time
+            // instead of holding on to a reference. Receivers added during the emit wait
+            // for the next one.
+            const std::size_t count = lists[family].delegates.size();
+            ++lists[family].emitting;
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const Delegate delegate = lists[family].delegates[i];
+                if (delegate.receiver)
+                {
+                    delegate.thunk(delegate.receiver, event);
+                }
+            }
+
+            DelegateList& list = lists[family];
+            if (--list.emitting == 0 && list.holes)
+            {
+                list.delegates.erase(std::remove_if(list.delegates.begin(), list.delegates.end(), [](const Delegate& delegate) { return delegate.receiver == nullptr; }), list.delegates.end());
+                list.holes = false;
+            }
+        }
+
+    private:
+        std::vector<DelegateList> lists;
+};
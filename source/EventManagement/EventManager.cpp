@@ -1,32 +1,171 @@
 #include "EventManager.hpp"
 
+#include <algorithm>
+
 BaseEvent::Family BaseEvent::familyCounter = 0;
 
 std::size_t EventManager::connectReceivers() const
+{
+    return eventHandlers->size() + batchHandlers->size() + entityHandlers->size();
+}
+
+void EventManager::dispatchQueued(EventPhase phase)
+{
+    TRACE_SCOPE("EventManager::dispatchQueued");
+
+    for (std::size_t family = 0; family < eventQueues.size(); ++family)
+    {
+        BaseEventQueue* queue = eventQueues[family].get();
+        if (queue && queue->dispatchPhase() == phase)
+        {
+            dispatchQueue(family);
+        }
+    }
+}
+
+void EventManager::dropEntitySubscriptions(Entity::Id entity)
+{
+    if (!holdRouteChange({ entity, Entity::INVALID_ID }))
+    {
+        entityHandlers->dropEntity(entity);
+    }
+}
+
+void EventManager::moveEntitySubscriptions(Entity::Id from, Entity::Id to)
+{
+    entityHandlers->moveEntity(from, to);
+
+    // Queued events about the entity still name from
+    if (holdRouteChange({ from, to }))
+    {
+        entityHandlers->aliasEntity(from, to);
+    }
+}
+
+std::size_t EventManager::queuedEvents() const
 {
     std::size_t size = 0;
-    for (const std::shared_ptr<EventSignal>& handler : eventHandlers)
+    for (const std::unique_ptr<BaseEventQueue>& queue : eventQueues)
     {
-        if (handler)
+        if (queue)
         {
-            size += handler->size();
+            size += queue->size();
         }
     }
 
     return size;
 }
 
-std::shared_ptr<EventSignal>& EventManager::signalFor(std::size_t handlerId)
+std::size_t EventManager::drainChannels()
+{
+    TRACE_SCOPE("EventManager::drainChannels");
+
+    std::size_t drained = 0;
+    for (const std::unique_ptr<BaseEventChannel>& channel : eventChannels)
+    {
+        if (channel)
+        {
+            drained += channel->drain(*this);
+        }
+    }
+
+    return drained;
+}
+
+EventChannelStats EventManager::channelStats() const
+{
+    EventChannelStats total = {};
+    for (const std::unique_ptr<BaseEventChannel>& channel : eventChannels)
+    {
+        if (channel)
+        {
+            const EventChannelStats stats = channel->stats();
+            total.capacity += stats.capacity;
+            total.depth += stats.depth;
+            total.highWater = std::max(total.highWater, stats.highWater);
+            total.sent += stats.sent;
+            total.dropped += stats.dropped;
+        }
+    }
+
+    return total;
+}
+
+void EventManager::dispatchQueue(std::size_t family)
 {
-    if (handlerId >= eventHandlers.size())
+    eventQueues[family]->dispatch(*eventHandlers, *batchHandlers, *entityHandlers);
+    ++queueDispatches[family];
+
+    if (!heldRouteChanges.empty())
     {
-        eventHandlers.resize(handlerId + 1);
+        applyHeldRouteChanges();
     }
+}
 
-    if (!eventHandlers[handlerId])
+bool EventManager::holdRouteChange(const RouteChange& change)
+{
+    if (entityHandlers->size() == 0)
+    {
+        return false;
+    }
+
+    // Events pushed during a dispatch go out with the next one, so a queue in the middle of
+    // a dispatch with more events pending has to get through two
+    waitScratch.clear();
+    for (std::size_t family = 0; family < eventQueues.size(); ++family)
     {
-        eventHandlers[handlerId] = std::make_shared<EventSignal>();
+        const BaseEventQueue* queue = eventQueues[family].get();
+        if (queue && queue->routesEntities())
+        {
+            const std::uint64_t dispatches = (queue->isDispatching() ? 1 : 0) + (queue->size() > 0 ? 1 : 0);
+            if (dispatches > 0)
+            {
+                waitScratch.emplace_back(family, queueDispatches[family] + dispatches);
+            }
+        }
     }
 
-    return eventHandlers[handlerId];
+    if (waitScratch.empty())
+    {
+        return false;
+    }
+
+    // Changes made between two dispatches all wait for the same ones
+    if (heldRouteChanges.empty() || heldRouteChanges.back().waitFor != waitScratch)
+    {
+        heldRouteChanges.push_back({ waitScratch, {} });
+    }
+
+    heldRouteChanges.back().changes.push_back(change);
+
+    return true;
+}
+
+void EventManager::applyHeldRouteChanges()
+{
+    while (!heldRouteChanges.empty())
+    {
+        const HeldRouteChanges& held = heldRouteChanges.front();
+        for (const std::pair<std::size_t, std::uint64_t>& wait : held.waitFor)
+        {
+            if (queueDispatches[wait.first] < wait.second)
+            {
+                return;
+            }
+        }
+
+        for (const RouteChange& change : held.changes)
+        {
+            if (change.movedTo == Entity::INVALID_ID)
+            {
+                entityHandlers->dropEntity(change.entity);
+            }
+            else
+            {
+                entityHandlers->forgetAlias(change.entity);
+            }
+        }
+
+        heldRouteChanges.pop_front();
+    }
 }
\ No newline at end of file
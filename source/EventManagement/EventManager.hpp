@@ -3,14 +3,26 @@
 #include <cstdint>
 #include <memory>
 #include <vector>
-#include <functional>
+#include <deque>
+#include <span>
 #include <unordered_map>
 #include <utility>
 #include <SFML/System/NonCopyable.hpp>
 
-#include "SimpleSignal.hpp"
+#include "EventDispatcher.hpp"
+#include "EntityEventRouter.hpp"
+#include "EventQueue.hpp"
+#include "EventChannel.hpp"
+#include "Helpers/TraceZones.hpp"
 
-using EventSignal = Simple::Signal<void (const void*)>;
+// Sees every event passed to emit(), before it is queued or dispatched. See EventTraceRecorder.
+class EventObserver
+{
+    public:
+        virtual ~EventObserver() {}
+
+        virtual void eventEmitted(std::size_t family, const void* event) = 0;
+};
 
 class EventManager : private sf::NonCopyable
 {
@@ -24,6 +36,26 @@ class EventManager : private sf::NonCopyable
         template <typename EventType, typename Receiver>
         void unsubscribe(Receiver& receiver);
 
+        // Entity Scoped Subscriptions
+        // The receiver only gets the EventType's about entity (see EventEntity), subscribe once
+        // per entity to watch a set. The subscriptions of an entity are dropped with
+        // dropEntitySubscriptions(), EntityManager calls it once the entity is destroyed. When an
+        // entity gets a new id (EntityManager::swapEntities) moveEntitySubscriptions() carries its
+        // subscriptions over, so they keep following the entity and still get dropped with it.
+        //
+        // Queued events name the entity by the id it had when they were emitted. While any are
+        // pending a drop waits, and the old id of a moved entity keeps routing to it, until the
+        // queues holding them have been dispatched. Events sent through a channel are routed by
+        // whatever id they carry once drained.
+        template <typename EventType, typename Receiver>
+        void subscribe(Receiver& receiver, Entity::Id entity);
+
+        template <typename EventType, typename Receiver>
+        void unsubscribe(Receiver& receiver, Entity::Id entity);
+
+        void dropEntitySubscriptions(Entity::Id entity);
+        void moveEntitySubscriptions(Entity::Id from, Entity::Id to);
+
         template <typename EventType>
         void emit(const EventType& event);
 
@@ -35,20 +67,101 @@ class EventManager : private sf::NonCopyable
 
         std::size_t connectReceivers() const;
 
+        // Only one observer at a time, nullptr removes it
+        void setObserver(EventObserver* eventObserver) { observer = eventObserver; }
+        EventObserver* getObserver() const { return observer; }
+
+        // Queued Dispatch
+        // Once queueEvents<EventType>() is called emit() only appends EventType to a contiguous
+        // buffer, the receivers get them in bulk when dispatchQueued() is called for phase.
+        // Batch receivers implement receive(std::span<const EventType>), regular receivers
+        // still get the events one by one. With coalesceKey only the last event for every key
+        // (e.g. the entity id) of the frame is dispatched. Neither this nor dispatchImmediately()
+        // can be called for EventType while its queue is being dispatched, the queue would be
+        // freed under the running dispatch.
+        template <typename EventType>
+        void queueEvents(EventPhase phase, typename EventQueue<EventType>::CoalesceKey coalesceKey = nullptr);
+
+        // Dispatches whatever is pending and switches EventType back to immediate dispatch
+        template <typename EventType>
+        void dispatchImmediately();
+
+        template <typename EventType, typename Receiver>
+        void subscribeBatch(Receiver& receiver);
+
+        template <typename EventType, typename Receiver>
+        void unsubscribeBatch(Receiver& receiver);
+
+        void dispatchQueued(EventPhase phase);
+        std::size_t queuedEvents() const;
+
+        // Cross Thread Channels
+        // EventManager itself is not thread safe. Other threads send() into the channel of an
+        // event type instead, drainChannels() emits what they sent on the owning thread. Create the
+        // channels up front, createChannel() returns the existing channel if there is one.
+        template <typename EventType>
+        EventChannel<EventType>& createChannel(std::size_t capacity = 1024);
+
+        template <typename EventType>
+        EventChannel<EventType>* channel();
+
+        std::size_t drainChannels();
+        EventChannelStats channelStats() const; // Summed over all channels, highWater is the deepest channel
+
     private:
-        std::shared_ptr<EventSignal>& signalFor(std::size_t handlerId);
+        template <typename EventType>
+        EventQueue<EventType>* queueFor();
 
+        // Immediate dispatch to the regular and the entity scoped receivers
         template <typename EventType>
-        struct EventCallbackWrapper
+        void dispatch(const EventType& event);
+
+        // Dispatches the queue of family, then applies the route changes that were waiting on it
+        void dispatchQueue(std::size_t family);
+
+        // A dropped entity, or one that moved to movedTo
+        struct RouteChange
         {
-            explicit EventCallbackWrapper(std::function<void (const EventType&)>& callback) : callback(callback) {}
-            void operator()(const void* event) { callback( *(static_cast<const EventType*>(event))); }
+            Entity::Id entity;
+            Entity::Id movedTo; // Entity::INVALID_ID for a drop
+        };
 
-            std::function<void (const EventType&)> callback;
+        // Route changes made while routable events were queued, applied in order once every
+        // queue in waitFor has been dispatched the given number of times
+        struct HeldRouteChanges
+        {
+            std::vector<std::pair<std::size_t, std::uint64_t>> waitFor; // Event family, dispatch count
+            std::vector<RouteChange> changes;
         };
 
+        // False if no queued event can name the entity, the change is to be applied right away
+        bool holdRouteChange(const RouteChange& change);
+        void applyHeldRouteChanges();
+
+        // Delegate thunks, receive() is resolved at compile time for every receiver type
+        template <typename Receiver, typename EventType>
+        static void invokeReceiver(void* receiver, const void* event)
+        {
+            static_cast<Receiver*>(receiver)->receive(*static_cast<const EventType*>(event));
+        }
+
+        template <typename Receiver, typename EventType>
+        static void invokeBatchReceiver(void* receiver, const void* batch)
+        {
+            static_cast<Receiver*>(receiver)->receive(*static_cast<const std::span<const EventType>*>(batch));
+        }
+
     private:
-        std::vector<std::shared_ptr<EventSignal>> eventHandlers;
+        // Shared so receivers outliving the manager can tell, emit() never touches the refcount
+        std::shared_ptr<EventDispatcher> eventHandlers = std::make_shared<EventDispatcher>();
+        std::shared_ptr<EventDispatcher> batchHandlers = std::make_shared<EventDispatcher>();
+        std::shared_ptr<EntityEventRouter> entityHandlers = std::make_shared<EntityEventRouter>();
+        std::vector<std::unique_ptr<BaseEventQueue>> eventQueues; // Indexed by event family, nullptr for immediate dispatch
+        std::vector<std::uint64_t> queueDispatches; // Indexed by event family, dispatches of the queue so far
+        std::deque<HeldRouteChanges> heldRouteChanges;
+        std::vector<std::pair<std::size_t, std::uint64_t>> waitScratch;
+        std::vector<std::unique_ptr<BaseEventChannel>> eventChannels; // Indexed by event family
+        EventObserver* observer = nullptr;
 };
 
 /// Base classes for the event system
@@ -82,10 +195,35 @@ class BaseReceiver
         {
             for (const auto& connection : connections)
             {
-                auto& ptr = connection.second.first;
-                if (!ptr.expired())
+                if (auto dispatcher = connection.second.first.lock())
+                {
+                    dispatcher->disconnect(connection.first, connection.second.second);
+                }
+            }
+
+            for (const auto& connection : batchConnections)
+            {
+                if (auto dispatcher = connection.second.first.lock())
+                {
+                    dispatcher->disconnect(connection.first, connection.second.second);
+                }
+            }
+
+            for (const EntityConnection& connection : entityConnections)
+            {
+                if (auto router = connection.router.lock())
+                {
+                    router->disconnect(connection.family, connection.entity, connection.receiver);
+                }
+            }
+
+            // Routes that moved along with their entity are keyed by ids the connections don't know
+            for (const auto& entityRouter : entityRouters)
+            {
+                auto router = entityRouter.first.lock();
+                if (router && router->hasMovedRoutes())
                 {
-                    ptr.lock()->disconnect(connection.second.second);
+                    router->disconnectReceiver(entityRouter.second);
                 }
             }
         }
@@ -107,7 +245,24 @@ class BaseReceiver
     private:
         friend class EventManager;
         
-        std::unordered_map<size_t, std::pair<std::weak_ptr<EventSignal>, std::size_t>> connections;
+        // Event family to the dispatcher and the receiver pointer the delegate was registered with
+        std::unordered_map<size_t, std::pair<std::weak_ptr<EventDispatcher>, void*>> connections;
+        std::unordered_map<size_t, std::pair<std::weak_ptr<EventDispatcher>, void*>> batchConnections;
+
+        struct EntityConnection
+        {
+            std::weak_ptr<EntityEventRouter> router;
+            std::size_t family;
+            Entity::Id entity;
+            void* receiver;
+        };
+
+        // Connections of destroyed entities linger until the next prune, see EventManager::subscribe()
+        std::vector<EntityConnection> entityConnections;
+        std::size_t entityConnectionsPruneAt = 64;
+
+        // Every router and receiver pointer entity connections were made with, usually just one
+        std::vector<std::pair<std::weak_ptr<EntityEventRouter>, void*>> entityRouters;
 };
 
 template <typename Derived>
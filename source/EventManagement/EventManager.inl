@@ -4,13 +4,12 @@ template <typename EventType, typename Receiver>
 void EventManager::subscribe(Receiver& receiver)
 {
     void (Receiver::*receive)(const EventType&) = &Receiver::receive;
+    (void)receive; // Only here so a missing receive(const EventType&) fails with a readable error
 
-    auto signal = signalFor(Event<EventType>::family());
-    auto wrapper = EventCallbackWrapper<EventType>(std::bind(receive, &receiver, std::placeholders::_1));
-    auto connection = signal->connect(wrapper);
+    eventHandlers->connect(Event<EventType>::family(), &receiver, &invokeReceiver<Receiver, EventType>);
 
     BaseReceiver& baseReceiver = receiver;
-    baseReceiver.connections.insert(std::make_pair(Event<EventType>::family(), std::make_pair(std::weak_ptr<EventSignal>(signal), connection)));
+    baseReceiver.connections.insert(std::make_pair(Event<EventType>::family(), std::make_pair(std::weak_ptr<EventDispatcher>(eventHandlers), static_cast<void*>(&receiver))));
 }
 
 template <typename EventType, typename Receiver>
@@ -21,35 +20,262 @@ void EventManager::unsubscribe(Receiver& receiver)
     assert(baseRec.connections.find(Event<EventType>::family()) != baseRec.connections.end());
 
     auto pair = baseRec.connections[Event<EventType>::family()];
-    auto connection = pair.second;
-    auto& ptr = pair.first;
-
-    if (!ptr.expired())
+    if (auto dispatcher = pair.first.lock())
     {
-        ptr.lock()->disconnect(connection);
+        dispatcher->disconnect(Event<EventType>::family(), pair.second);
     }
 
     baseRec.connections.erase(Event<EventType>::family());
 }
 
+template <typename EventType, typename Receiver>
+void EventManager::subscribe(Receiver& receiver, Entity::Id entity)
+{
+    static_assert(RoutableEvent<EventType>, "EventManager ~ Specialize EventEntity to subscribe to this event per entity");
+
+    void (Receiver::*receive)(const EventType&) = &Receiver::receive;
+    (void)receive;
+
+    entityHandlers->connect(Event<EventType>::family(), entity, &receiver, &invokeReceiver<Receiver, EventType>);
+
+    BaseReceiver& baseReceiver = receiver;
+    auto& connections = baseReceiver.entityConnections;
+
+    // Receivers watching a stream of short lived entities would pile up dropped connections
+    if (connections.size() >= baseReceiver.entityConnectionsPruneAt)
+    {
+        connections.erase(std::remove_if(connections.begin(), connections.end(), [](const BaseReceiver::EntityConnection& connection)
+        {
+            auto router = connection.router.lock();
+            return !router || !router->isConnected(connection.family, connection.entity, connection.receiver);
+        }), connections.end());
+
+        baseReceiver.entityConnectionsPruneAt = std::max<std::size_t>(64, connections.size() * 2);
+    }
+
+    connections.push_back({ entityHandlers, Event<EventType>::family(), entity, static_cast<void*>(&receiver) });
+
+    auto& routers = baseReceiver.entityRouters;
+    const bool knownRouter = std::any_of(routers.begin(), routers.end(), [this, &receiver](const std::pair<std::weak_ptr<EntityEventRouter>, void*>& router)
+    {
+        return router.second == static_cast<void*>(&receiver) && router.first.lock() == entityHandlers;
+    });
+
+    if (!knownRouter)
+    {
+        routers.emplace_back(entityHandlers, static_cast<void*>(&receiver));
+    }
+}
+
+template <typename EventType, typename Receiver>
+void EventManager::unsubscribe(Receiver& receiver, Entity::Id entity)
+{
+    BaseReceiver& baseRec = receiver;
+    auto& connections = baseRec.entityConnections;
+
+    auto it = std::find_if(connections.begin(), connections.end(), [&entity](const BaseReceiver::EntityConnection& connection)
+    {
+        return connection.family == Event<EventType>::family() && connection.entity == entity;
+    });
+
+    // Connections keep the id the entity had when subscribing, after a move only the router knows the new one
+    if (it == connections.end())
+    {
+        const bool disconnected = entityHandlers->disconnect(Event<EventType>::family(), entity, static_cast<void*>(&receiver));
+        assert(disconnected && "EventManager ~ Receiver is not subscribed to this entity");
+        (void)disconnected;
+
+        return;
+    }
+
+    if (auto router = it->router.lock())
+    {
+        router->disconnect(it->family, it->entity, it->receiver);
+    }
+
+    connections.erase(it);
+}
+
+template <typename EventType>
+void EventManager::dispatch(const EventType& event)
+{
+    const std::size_t family = Event<EventType>::family();
+    eventHandlers->emit(family, &event);
+
+    if constexpr (RoutableEvent<EventType>)
+    {
+        if (entityHandlers->hasRoutes(family))
+        {
+            entityHandlers->emit(family, EventEntity<EventType>::get(event), &event);
+        }
+    }
+}
+
 template <typename EventType>
 void EventManager::emit(const EventType& event)
 {
-    auto signal = signalFor(Event<EventType>::family());
-    signal->emit(&event);
+    TRACE_SCOPE("EventManager::emit");
+
+    if (observer)
+    {
+        observer->eventEmitted(Event<EventType>::family(), &event);
+    }
+
+    if (EventQueue<EventType>* queue = queueFor<EventType>())
+    {
+        queue->push(event);
+        return;
+    }
+
+    dispatch(event);
 }
 
 template <typename EventType>
 void EventManager::emit(std::unique_ptr<EventType> event)
 {
-    auto signal = signalFor(Event<EventType>::family());
-    signal->emit(event.get());
+    TRACE_SCOPE("EventManager::emit");
+
+    if (observer)
+    {
+        observer->eventEmitted(Event<EventType>::family(), event.get());
+    }
+
+    if (EventQueue<EventType>* queue = queueFor<EventType>())
+    {
+        queue->push(*event);
+        return;
+    }
+
+    dispatch(*event);
 }
 
 template <typename EventType, typename ... EventArgs>
 void EventManager::emit(EventArgs&& ... args)
 {
+    TRACE_SCOPE("EventManager::emit");
+
+    if (observer)
+    {
+        // The observer needs the event built, take the regular path
+        const EventType event(std::forward<EventArgs>(args)...);
+        emit(event);
+        return;
+    }
+
+    if (EventQueue<EventType>* queue = queueFor<EventType>())
+    {
+        queue->emplace(std::forward<EventArgs>(args)...);
+        return;
+    }
+
+    // Nobody to hand it to, don't even build the event
+    if (!eventHandlers->hasReceivers(Event<EventType>::family()) && !entityHandlers->hasRoutes(Event<EventType>::family()))
+    {
+        return;
+    }
+
     EventType event = EventType(std::forward<EventArgs>(args)...);
-    auto signal = signalFor(Event<EventType>::family());
-    signal->emit(&event);
+    dispatch(event);
+}
+
+template <typename EventType>
+void EventManager::queueEvents(EventPhase phase, typename EventQueue<EventType>::CoalesceKey coalesceKey)
+{
+    const std::size_t family = Event<EventType>::family();
+    if (family >= eventQueues.size())
+    {
+        eventQueues.resize(family + 1);
+        queueDispatches.resize(family + 1, 0);
+    }
+
+    assert((!eventQueues[family] || !eventQueues[family]->isDispatching()) && "EventManager ~ Can't reconfigure the queue of an event type from one of its receivers");
+
+    if (eventQueues[family])
+    {
+        dispatchQueue(family);
+    }
+
+    eventQueues[family] = std::make_unique<EventQueue<EventType>>(family, phase, std::move(coalesceKey));
+}
+
+template <typename EventType>
+void EventManager::dispatchImmediately()
+{
+    const std::size_t family = Event<EventType>::family();
+    if (family < eventQueues.size() && eventQueues[family])
+    {
+        assert(!eventQueues[family]->isDispatching() && "EventManager ~ Can't reconfigure the queue of an event type from one of its receivers");
+
+        dispatchQueue(family);
+        eventQueues[family].reset();
+    }
+}
+
+template <typename EventType, typename Receiver>
+void EventManager::subscribeBatch(Receiver& receiver)
+{
+    void (Receiver::*receive)(std::span<const EventType>) = &Receiver::receive;
+    (void)receive;
+
+    batchHandlers->connect(Event<EventType>::family(), &receiver, &invokeBatchReceiver<Receiver, EventType>);
+
+    BaseReceiver& baseReceiver = receiver;
+    baseReceiver.batchConnections.insert(std::make_pair(Event<EventType>::family(), std::make_pair(std::weak_ptr<EventDispatcher>(batchHandlers), static_cast<void*>(&receiver))));
+}
+
+template <typename EventType, typename Receiver>
+void EventManager::unsubscribeBatch(Receiver& receiver)
+{
+    BaseReceiver& baseRec = receiver;
+
+    assert(baseRec.batchConnections.find(Event<EventType>::family()) != baseRec.batchConnections.end());
+
+    auto pair = baseRec.batchConnections[Event<EventType>::family()];
+    if (auto dispatcher = pair.first.lock())
+    {
+        dispatcher->disconnect(Event<EventType>::family(), pair.second);
+    }
+
+    baseRec.batchConnections.erase(Event<EventType>::family());
+}
+
+template <typename EventType>
+EventChannel<EventType>& EventManager::createChannel(std::size_t capacity)
+{
+    const std::size_t family = Event<EventType>::family();
+    if (family >= eventChannels.size())
+    {
+        eventChannels.resize(family + 1);
+    }
+
+    if (!eventChannels[family])
+    {
+        eventChannels[family] = std::make_unique<EventChannel<EventType>>(capacity);
+    }
+
+    return *static_cast<EventChannel<EventType>*>(eventChannels[family].get());
+}
+
+template <typename EventType>
+EventChannel<EventType>* EventManager::channel()
+{
+    const std::size_t family = Event<EventType>::family();
+    if (family >= eventChannels.size())
+    {
+        return nullptr;
+    }
+
+    return static_cast<EventChannel<EventType>*>(eventChannels[family].get());
+}
+
+template <typename EventType>
+EventQueue<EventType>* EventManager::queueFor()
+{
+    const std::size_t family = Event<EventType>::family();
+    if (family >= eventQueues.size())
+    {
+        return nullptr;
+    }
+
+    return static_cast<EventQueue<EventType>*>(eventQueues[family].get());
 }
\ No newline at end of file
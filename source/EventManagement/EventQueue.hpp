@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <span>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+#include "EventDispatcher.hpp"
+#include "EntityEventRouter.hpp"
+
+// Points in the frame where queued events get dispatched, see EventManager::queueEvents()
+enum class EventPhase : std::uint8_t
+{
+    PreUpdate,  // Before the systems are updated
+    PostUpdate, // After every system has been updated
+    PostRender  // End of the frame
+};
+
+// Internal, type erased part of EventQueue used by EventManager
+class BaseEventQueue
+{
+    public:
+        BaseEventQueue(std::size_t family, EventPhase phase)
+            : family(family)
+            , phase(phase)
+        {}
+
+        virtual ~BaseEventQueue() {}
+
+        EventPhase dispatchPhase() const { return phase; }
+        bool isDispatching() const { return inDispatch; }
+
+        // Hands the queued events to the batch receivers, then one by one to the
+        // immediate and the entity scoped receivers.
+        virtual void dispatch(EventDispatcher& immediateHandlers, EventDispatcher& batchHandlers, EntityEventRouter& entityHandlers) = 0;
+        virtual std::size_t size() const = 0;
+
+        // True if the events are routed to entity scoped receivers (RoutableEvent)
+        virtual bool routesEntities() const = 0;
+
+    protected:
+        std::size_t family;
+        EventPhase phase;
+        bool inDispatch = false;
+};
+
+// Contiguous buffer of pending events of one type. Events emitted while the queue is
+// dispatched, by the receivers for example, go out on the next dispatch.
+template <typename EventType>
+class EventQueue : public BaseEventQueue
+{
+    public:
+        using CoalesceKey = std::function<std::uint64_t (const EventType&)>;
+
+        EventQueue(std::size_t family, EventPhase phase, CoalesceKey coalesceKey)
+            : BaseEventQueue(family, phase)
+            , coalesceKey(std::move(coalesceKey))
+        {}
+
+        void push(const EventType& event) { events.push_back(event); }
+
+        template <typename ... EventArgs>
+        void emplace(EventArgs&& ... args) { events.emplace_back(std::forward<EventArgs>(args)...); }
+
+        virtual std::size_t size() const override { return events.size(); }
+        virtual bool routesEntities() const override { return RoutableEvent<EventType>; }
+
+        virtual void dispatch(EventDispatcher& immediateHandlers, EventDispatcher& batchHandlers, EntityEventRouter& entityHandlers) override
+        {
+            if (events.empty())
+            {
+                return;
+            }
+
+            dispatching.swap(events);
+            if (coalesceKey)
+            {
+                coalesce();
+            }
+
+            inDispatch = true;
+
+            // Batch receivers get a pointer to the span
+            const std::span<const EventType> batch(dispatching.data(), dispatching.size());
+            batchHandlers.emit(family, &batch);
+
+            if (immediateHandlers.hasReceivers(family))
+            {
+                for (const EventType& event : dispatching)
+                {
+                    immediateHandlers.emit(family, &event);
+                }
+            }
+
+            if constexpr (RoutableEvent<EventType>)
+            {
+                if (entityHandlers.hasRoutes(family))
+                {
+                    for (const EventType& event : dispatching)
+                    {
+                        entityHandlers.emit(family, EventEntity<EventType>::get(event), &event);
+                    }
+                }
+            }
+
+            dispatching.clear();
+            inDispatch = false;
+        }
+
+    private:
+        // Only the last event for every key survives, in the order of those last events
+        void coalesce()
+        {
+            lastEvent.clear();
+            for (std::size_t i = 0; i < dispatching.size(); ++i)
+            {
+                lastEvent[coalesceKey(dispatching[i])] = i;
+            }
+
+            if (lastEvent.size() == dispatching.size())
+            {
+                return;
+            }
+
+            std::size_t kept = 0;
+            for (std::size_t i = 0; i < dispatching.size(); ++i)
+            {
+                if (lastEvent[coalesceKey(dispatching[i])] == i)
+                {
+                    if (kept != i)
+                    {
+                        dispatching[kept] = dispatching[i];
+                    }
+
+                    ++kept;
+                }
+            }
+
+            dispatching.erase(dispatching.begin() + kept, dispatching.end());
+        }
+
+    private:
+        CoalesceKey coalesceKey;
+        std::vector<EventType> events;
+        std::vector<EventType> dispatching;
+        std::unordered_map<std::uint64_t, std::size_t> lastEvent;
+};
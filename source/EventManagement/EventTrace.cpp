@@ -0,0 +1,188 @@
+#include "EventTrace.hpp"
+
+#include <ostream>
+#include <algorithm>
+
+namespace
+{
+    const std::uint8_t TraceMagic[4] = { 'E', 'V', 'T', 'R' };
+    const std::uint8_t TraceVersion = 1;
+    const std::size_t HeaderSize = sizeof(TraceMagic) + 1;
+}
+
+const EventTraceCodecs::Codec* EventTraceCodecs::codecForTraceId(std::uint16_t traceId) const
+{
+    auto it = byTraceId.find(traceId);
+
+    return it != byTraceId.end() ? &codecs[it->second] : nullptr;
+}
+
+EventTraceRecorder::EventTraceRecorder(const EventTraceCodecs& codecs, std::size_t maxBytes)
+    : codecs(codecs)
+    , maxBytes(maxBytes)
+{}
+
+void EventTraceRecorder::beginFrame(std::uint32_t frame)
+{
+    if (maxBytes > 0 && recordBytes > maxBytes)
+    {
+        trim();
+    }
+
+    frames.push_back(std::move(spareFrame));
+    frames.back().clear();
+    spareFrame = std::vector<std::uint8_t>();
+
+    // Frame markers are trace id 0 with the frame number as the payload
+    payload.clear();
+    EventTraceWriter(payload).writeVarint(frame);
+    append(0);
+}
+
+void EventTraceRecorder::eventEmitted(std::size_t family, const void* event)
+{
+    const EventTraceCodecs::Codec* codec = codecs.codecForFamily(family);
+    if (!codec)
+    {
+        return;
+    }
+
+    payload.clear();
+    EventTraceWriter payloadWriter(payload);
+    codec->encode(event, payloadWriter);
+
+    // Events from before the first beginFrame() get a chunk without a marker
+    if (frames.empty())
+    {
+        frames.emplace_back();
+    }
+
+    append(codec->traceId);
+    ++eventCount;
+}
+
+void EventTraceRecorder::save(std::ostream& output) const
+{
+    output.write(reinterpret_cast<const char*>(TraceMagic), sizeof(TraceMagic));
+    output.put(static_cast<char>(TraceVersion));
+    for (const std::vector<std::uint8_t>& records : frames)
+    {
+        output.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size()));
+    }
+}
+
+std::vector<std::uint8_t> EventTraceRecorder::trace() const
+{
+    std::vector<std::uint8_t> result;
+    result.reserve(HeaderSize + recordBytes);
+    result.insert(result.end(), TraceMagic, TraceMagic + sizeof(TraceMagic));
+    result.push_back(TraceVersion);
+    for (const std::vector<std::uint8_t>& records : frames)
+    {
+        result.insert(result.end(), records.begin(), records.end());
+    }
+
+    return result;
+}
+
+void EventTraceRecorder::clear()
+{
+    frames.clear();
+    recordBytes = 0;
+    eventCount = 0;
+    droppedFrameCount = 0;
+}
+
+void EventTraceRecorder::trim()
+{
+    // Drop whole frames from the front until the trace fits again, the newest frame always stays
+    while (frames.size() > 1 && recordBytes > maxBytes)
+    {
+        recordBytes -= frames.front().size();
+        spareFrame = std::move(frames.front());
+        frames.pop_front();
+
+        ++droppedFrameCount;
+    }
+}
+
+void EventTraceRecorder::append(std::uint16_t traceId)
+{
+    std::vector<std::uint8_t>& records = frames.back();
+    const std::size_t before = records.size();
+
+    EventTraceWriter writer(records);
+    writer.writeVarint(traceId);
+    writer.writeVarint(payload.size());
+    records.insert(records.end(), payload.begin(), payload.end());
+
+    recordBytes += records.size() - before;
+}
+
+EventTraceReplayer::EventTraceReplayer(const EventTraceCodecs& codecs, std::vector<std::uint8_t> trace)
+    : codecs(codecs)
+    , data(std::move(trace))
+    , reader(data.data(), data.size())
+    , validTrace(data.size() >= HeaderSize && std::memcmp(data.data(), TraceMagic, sizeof(TraceMagic)) == 0 && data[sizeof(TraceMagic)] == TraceVersion)
+{
+    rewind();
+}
+
+bool EventTraceReplayer::replayFrame(EventManager& eventManager)
+{
+    bool inFrame = false;
+    while (!finished())
+    {
+        // Peek at the id, a frame marker ends the current frame
+        const std::size_t recordStart = reader.offset();
+        const std::uint16_t traceId = static_cast<std::uint16_t>(reader.readVarint());
+        const std::size_t payloadSize = static_cast<std::size_t>(reader.readVarint());
+
+        if (traceId == 0)
+        {
+            if (inFrame)
+            {
+                reader = EventTraceReader(data.data(), data.size());
+                reader.skip(recordStart);
+
+                return true;
+            }
+
+            currentFrame = static_cast<std::uint32_t>(reader.readVarint());
+            inFrame = true;
+            continue;
+        }
+
+        const EventTraceCodecs::Codec* codec = codecs.codecForTraceId(traceId);
+        if (!codec)
+        {
+            reader.skip(payloadSize);
+            ++skippedCount;
+            continue;
+        }
+
+        // Decode from a reader bounded to the payload so a bad codec can't run into the next record
+        EventTraceReader payloadReader(data.data() + reader.offset(), std::min(payloadSize, reader.remaining()));
+        reader.skip(payloadSize);
+        codec->replay(payloadReader, eventManager);
+        ++replayedCount;
+        inFrame = true;
+    }
+
+    return inFrame;
+}
+
+void EventTraceReplayer::replayAll(EventManager& eventManager)
+{
+    while (replayFrame(eventManager))
+    {}
+}
+
+void EventTraceReplayer::rewind()
+{
+    reader = EventTraceReader(data.data(), data.size());
+    reader.skip(validTrace ? HeaderSize : data.size());
+    currentFrame = 0;
+    replayedCount = 0;
+    skippedCount = 0;
+}
@@ -0,0 +1,254 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cassert>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <iosfwd>
+#include <type_traits>
+
+#include "EventManager.hpp"
+
+// Event traces, for capturing the event load of a session and re-injecting it offline
+// (under a profiler, or to measure dispatch throughput on real traffic).
+//
+// Event families depend on the order types are first used, so traces identify event types
+// by a trace id picked when registering the codec. Both sides register the same ids:
+//
+//      EventTraceCodecs codecs;
+//      codecs.registerEvent<EntityCreatedEvent>(1,
+//          [](const EntityCreatedEvent& event, EventTraceWriter& writer) { writer.write(event.entity.id().getId()); },
+//          [&](EventTraceReader& reader) { return EntityCreatedEvent(Entity(&entityManager, Entity::Id(reader.read<std::uint64_t>()))); });
+//
+//      EventTraceRecorder recorder(codecs, 4 * 1024 * 1024); // Keep the last ~4MB of events
+//      eventManager.setObserver(&recorder);
+//      ...
+//      recorder.beginFrame(frame); // Once per frame
+//      ...
+//      recorder.save(file);
+//
+// Layout: "EVTR", version (1 byte), then records of varint trace id, varint payload size and
+// the payload. Trace id 0 marks the start of a frame, its payload is the varint frame number.
+//
+// NOTE: Events of types without a codec are not recorded. Every event has a vtable (BaseEvent),
+// so codecs always write the members, never the event itself.
+
+class EventTraceWriter
+{
+    public:
+        explicit EventTraceWriter(std::vector<std::uint8_t>& output) : output(output) {}
+
+        template <typename T>
+        void write(const T& value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "EventTraceWriter ~ Write the members of non trivially copyable types");
+
+            const std::size_t offset = output.size();
+            output.resize(offset + sizeof(T));
+            std::memcpy(output.data() + offset, &value, sizeof(T));
+        }
+
+        void writeVarint(std::uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                output.push_back(static_cast<std::uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+
+            output.push_back(static_cast<std::uint8_t>(value));
+        }
+
+    private:
+        std::vector<std::uint8_t>& output;
+};
+
+class EventTraceReader
+{
+    public:
+        EventTraceReader(const std::uint8_t* data, std::size_t size) : data(data), size(size) {}
+
+        template <typename T>
+        T read()
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "EventTraceReader ~ Read the members of non trivially copyable types");
+
+            T value{};
+            if (position + sizeof(T) > size)
+            {
+                error = true;
+                return value;
+            }
+
+            std::memcpy(&value, data + position, sizeof(T));
+            position += sizeof(T);
+
+            return value;
+        }
+
+        std::uint64_t readVarint()
+        {
+            std::uint64_t value = 0;
+            for (unsigned shift = 0; shift < 64; shift += 7)
+            {
+                if (position >= size)
+                {
+                    error = true;
+                    return 0;
+                }
+
+                const std::uint8_t byte = data[position++];
+                value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80))
+                {
+                    return value;
+                }
+            }
+
+            error = true;
+            return value;
+        }
+
+        void skip(std::size_t bytes)
+        {
+            position = bytes > size - position ? size : position + bytes;
+        }
+
+        std::size_t offset() const { return position; }
+        std::size_t remaining() const { return size - position; }
+        bool failed() const { return error; }
+
+    private:
+        const std::uint8_t* data;
+        std::size_t size;
+        std::size_t position = 0;
+        bool error = false;
+};
+
+class EventTraceCodecs
+{
+    public:
+        template <typename EventType>
+        using Encoder = std::function<void (const EventType&, EventTraceWriter&)>;
+
+        template <typename EventType>
+        using Decoder = std::function<EventType (EventTraceReader&)>;
+
+        // traceId 0 is reserved for the frame markers
+        template <typename EventType>
+        void registerEvent(std::uint16_t traceId, Encoder<EventType> encoder, Decoder<EventType> decoder);
+
+    private:
+        friend class EventTraceRecorder;
+        friend class EventTraceReplayer;
+
+        struct Codec
+        {
+            std::uint16_t traceId;
+            std::function<void (const void*, EventTraceWriter&)> encode;
+            std::function<void (EventTraceReader&, EventManager&)> replay;
+        };
+
+        const Codec* codecForFamily(std::size_t family) const { return family < byFamily.size() && byFamily[family] >= 0 ? &codecs[byFamily[family]] : nullptr; }
+        const Codec* codecForTraceId(std::uint16_t traceId) const;
+
+    private:
+        std::vector<Codec> codecs;
+        std::vector<int> byFamily; // Index into codecs, -1 if the family has no codec
+        std::unordered_map<std::uint16_t, std::size_t> byTraceId;
+};
+
+// Records every emitted event that has a codec. With maxBytes the oldest frames are dropped once
+// the trace gets bigger than that, otherwise everything is kept until save(). Every frame is a
+// chunk of its own, dropping one hands its buffer to the next frame, so a full recorder neither
+// moves the rest of the trace nor allocates.
+class EventTraceRecorder : public EventObserver
+{
+    public:
+        explicit EventTraceRecorder(const EventTraceCodecs& codecs, std::size_t maxBytes = 0);
+
+        void beginFrame(std::uint32_t frame);
+
+        virtual void eventEmitted(std::size_t family, const void* event) override;
+
+        // Writes the header and every record still held
+        void save(std::ostream& output) const;
+        std::vector<std::uint8_t> trace() const;
+
+        void clear();
+
+        std::size_t recordedEvents() const { return eventCount; }
+        std::size_t droppedFrames() const { return droppedFrameCount; }
+        std::size_t size() const { return recordBytes; }
+
+    private:
+        void trim();
+        void append(std::uint16_t traceId);
+
+    private:
+        const EventTraceCodecs& codecs;
+        std::size_t maxBytes;
+        std::deque<std::vector<std::uint8_t>> frames; // Records of every frame still held, oldest first
+        std::vector<std::uint8_t> spareFrame; // Buffer of the last dropped frame, reused for the next one
+        std::vector<std::uint8_t> payload;
+        std::size_t recordBytes = 0;
+        std::size_t eventCount = 0;
+        std::size_t droppedFrameCount = 0;
+};
+
+// Re-emits a recorded trace through an EventManager, frame by frame in the recorded order.
+class EventTraceReplayer
+{
+    public:
+        EventTraceReplayer(const EventTraceCodecs& codecs, std::vector<std::uint8_t> trace);
+
+        // False if the trace is not an event trace
+        bool valid() const { return validTrace; }
+
+        // Emits the events of the next recorded frame, false once the trace is exhausted
+        bool replayFrame(EventManager& eventManager);
+        void replayAll(EventManager& eventManager);
+
+        // Back to the first frame
+        void rewind();
+
+        std::uint32_t frame() const { return currentFrame; }
+        bool finished() const { return !validTrace || reader.remaining() == 0 || reader.failed(); }
+        std::size_t replayedEvents() const { return replayedCount; }
+        std::size_t skippedEvents() const { return skippedCount; } // Trace ids without a codec
+
+    private:
+        const EventTraceCodecs& codecs;
+        std::vector<std::uint8_t> data;
+        EventTraceReader reader;
+        bool validTrace;
+        std::uint32_t currentFrame = 0;
+        std::size_t replayedCount = 0;
+        std::size_t skippedCount = 0;
+};
+
+template <typename EventType>
+void EventTraceCodecs::registerEvent(std::uint16_t traceId, Encoder<EventType> encoder, Decoder<EventType> decoder)
+{
+    assert(traceId != 0 && "EventTraceCodecs ~ Trace id 0 is reserved for frame markers");
+    assert(byTraceId.find(traceId) == byTraceId.end() && "EventTraceCodecs ~ Trace id registered twice");
+
+    const std::size_t family = Event<EventType>::family();
+    if (family >= byFamily.size())
+    {
+        byFamily.resize(family + 1, -1);
+    }
+
+    Codec codec;
+    codec.traceId = traceId;
+    codec.encode = [encoder](const void* event, EventTraceWriter& writer) { encoder(*static_cast<const EventType*>(event), writer); };
+    codec.replay = [decoder](EventTraceReader& reader, EventManager& eventManager) { eventManager.emit(decoder(reader)); };
+
+    byFamily[family] = static_cast<int>(codecs.size());
+    byTraceId[traceId] = codecs.size();
+    codecs.push_back(std::move(codec));
+}
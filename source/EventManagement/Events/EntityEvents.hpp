@@ -16,5 +16,18 @@ struct EntityDestroyedEvent : public Event<EntityDestroyedEvent>
     explicit EntityDestroyedEvent(const Entity& entity) : entity(entity) {}
     virtual ~EntityDestroyedEvent() {}
 
+    Entity entity;
+};
+
+// Emitted when EntityManager moves an entity to another storage slot. previousId is
+// stale afterwards, anything that stored it (or an EntityHandle to it) should switch to entity.
+// Routed by the new id like any other event, EntityManager moves the entity scoped
+// subscriptions over to it before the event goes out.
+struct EntityMovedEvent : public Event<EntityMovedEvent>
+{
+    EntityMovedEvent(Entity::Id previousId, const Entity& entity) : previousId(previousId), entity(entity) {}
+    virtual ~EntityMovedEvent() {}
+
+    Entity::Id previousId;
     Entity entity;
 };
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <tuple>
+#include <utility>
+
+#include "EventManager.hpp"
+
+// Event bus with the receivers fixed at compile time, for engine events whose receivers are
+// known when the engine is built. emit() calls receive() on every receiver type that has an
+// overload for the event, directly and in the order of the type list, so the compiler can
+// inline the whole dispatch. No type erasure, no family lookup and no heap.
+//
+//      StaticEventBus<RenderSystem, SpatialReorderSystem> bus(eventManager, renderSystem, reorderSystem);
+//      bus.emit<EntityCreatedEvent>(entity);
+//
+// Passing an EventManager forwards every event to it afterwards, so runtime subscribers, queues
+// and the observer still see them. Without one only the static receivers get the events.
+//
+// NOTE: The bus holds references, the receivers have to outlive it. Receivers don't subscribe
+// to the bus, a receiver without a matching receive() is skipped at compile time.
+template <typename ... Receivers>
+class StaticEventBus
+{
+    public:
+        explicit StaticEventBus(Receivers& ... receivers)
+            : receivers(&receivers...)
+        {}
+
+        StaticEventBus(EventManager& dynamicEvents, Receivers& ... receivers)
+            : receivers(&receivers...)
+            , dynamicEvents(&dynamicEvents)
+        {}
+
+        template <typename EventType>
+        void emit(const EventType& event) const
+        {
+            std::apply([&event](Receivers* ... receiver) { (deliver(*receiver, event), ...); }, receivers);
+
+            if (dynamicEvents)
+            {
+                dynamicEvents->emit(event);
+            }
+        }
+
+        template <typename EventType, typename ... EventArgs>
+        void emit(EventArgs&& ... args) const
+        {
+            const EventType event(std::forward<EventArgs>(args)...);
+            emit(event);
+        }
+
+        // True if any of the static receivers handles EventType
+        template <typename EventType>
+        static constexpr bool handles()
+        {
+            return (HasReceive<Receivers, EventType> || ...);
+        }
+
+        template <typename Receiver>
+        Receiver& receiver() const { return *std::get<Receiver*>(receivers); }
+
+        EventManager* dynamicEventManager() const { return dynamicEvents; }
+
+    private:
+        template <typename Receiver, typename EventType>
+        static constexpr bool HasReceive = requires(Receiver& receiver, const EventType& event) { receiver.receive(event); };
+
+        template <typename Receiver, typename EventType>
+        static void deliver(Receiver& receiver, const EventType& event)
+        {
+            if constexpr (HasReceive<Receiver, EventType>)
+            {
+                receiver.receive(event);
+            }
+        }
+
+    private:
+        std::tuple<Receivers*...> receivers;
+        EventManager* dynamicEvents = nullptr;
+};
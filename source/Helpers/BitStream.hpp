@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <vector>
+
+// Minimal LSB first bit packing used by the state streams. The writer appends to a
+// caller owned byte vector so the buffer can be reused between frames.
+class BitWriter
+{
+    public:
+        explicit BitWriter(std::vector<std::uint8_t>& output)
+            : output(output)
+        {}
+
+        ~BitWriter() { flush(); }
+
+        void write(std::uint32_t value, unsigned bitCount)
+        {
+            assert(bitCount <= 32);
+
+            if (bitCount < 32)
+            {
+                value &= (1U << bitCount) - 1U;
+            }
+
+            scratch |= static_cast<std::uint64_t>(value) << scratchBits;
+            scratchBits += bitCount;
+
+            while (scratchBits >= 8)
+            {
+                output.push_back(static_cast<std::uint8_t>(scratch));
+                scratch >>= 8;
+                scratchBits -= 8;
+            }
+        }
+
+        void writeBit(bool bit) { write(bit ? 1U : 0U, 1); }
+
+        // Elias gamma code, small values take few bits. value must be at least 1.
+        void writeGamma(std::uint32_t value)
+        {
+            assert(value > 0);
+
+            unsigned length = 0;
+            while ((value >> length) > 1U)
+            {
+                ++length;
+            }
+
+            write(0, length);
+            write(1, 1);
+            write(value, length);
+        }
+
+        // Pads the last byte with zeros, must be called before output is read.
+        void flush()
+        {
+            if (scratchBits > 0)
+            {
+                output.push_back(static_cast<std::uint8_t>(scratch));
+                scratch = 0;
+                scratchBits = 0;
+            }
+        }
+
+    private:
+        std::vector<std::uint8_t>& output;
+        std::uint64_t scratch = 0;
+        unsigned scratchBits = 0;
+};
+
+class BitReader
+{
+    public:
+        BitReader(const std::uint8_t* data, std::size_t size)
+            : data(data)
+            , size(size)
+        {}
+
+        std::uint32_t read(unsigned bitCount)
+        {
+            assert(bitCount <= 32);
+
+            while (scratchBits < bitCount)
+            {
+                if (cursor >= size)
+                {
+                    overrun = true;
+                    return 0;
+                }
+
+                scratch |= static_cast<std::uint64_t>(data[cursor++]) << scratchBits;
+                scratchBits += 8;
+            }
+
+            const std::uint32_t value = bitCount < 32 ? static_cast<std::uint32_t>(scratch & ((1ULL << bitCount) - 1ULL))
+                                                      : static_cast<std::uint32_t>(scratch);
+            scratch >>= bitCount;
+            scratchBits -= bitCount;
+
+            return value;
+        }
+
+        bool readBit() { return read(1) != 0; }
+
+        std::uint32_t readGamma()
+        {
+            unsigned length = 0;
+            while (!readBit())
+            {
+                if (overrun || ++length > 31)
+                {
+                    overrun = true;
+                    return 0;
+                }
+            }
+
+            return (1U << length) | read(length);
+        }
+
+        // True once a read went past the end of the data, everything read after that is 0.
+        bool failed() const { return overrun; }
+
+    private:
+        const std::uint8_t* data;
+        std::size_t size;
+        std::size_t cursor = 0;
+        std::uint64_t scratch = 0;
+        unsigned scratchBits = 0;
+        bool overrun = false;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+// Where the component pools and entity tables get their memory from. It is a regular
+// std::pmr::memory_resource with a couple of access hints on top, the default simply
+// forwards to new/delete and ignores the hints.
+class ChunkStorage : public std::pmr::memory_resource
+{
+    public:
+        // The range is about to be read, start paging it in.
+        virtual void willNeed(const void* data, std::size_t bytes) {}
+
+        // The range is going to be read front to back (view iteration).
+        virtual void adviseSequential(const void* data, std::size_t bytes) {}
+
+        // True if memory lives outside of RAM and the hints are worth calling.
+        virtual bool isPaged() const { return false; }
+
+        static ChunkStorage* heap();
+};
+
+class HeapChunkStorage : public ChunkStorage
+{
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* data, std::size_t bytes, std::size_t alignment) override
+        {
+            std::pmr::new_delete_resource()->deallocate(data, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+};
+
+inline ChunkStorage* ChunkStorage::heap()
+{
+    static HeapChunkStorage storage;
+
+    return &storage;
+}
@@ -0,0 +1,189 @@
+#include "FrameArena.hpp"
+
+#include <memory>
+#include <mutex>
+#include <algorithm>
+
+std::atomic<std::uint64_t> FrameArena::frameCounter{ 0 };
+
+namespace
+{
+    std::size_t alignUp(std::uintptr_t address, std::size_t alignment)
+    {
+        return static_cast<std::size_t>((address + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1));
+    }
+
+    struct Registry
+    {
+        std::mutex lock;
+        std::vector<std::unique_ptr<FrameArena>> arenas; // Outlive their threads, stats() may still read them
+    };
+
+    Registry& registry()
+    {
+        static Registry instance;
+
+        return instance;
+    }
+
+    thread_local FrameArena* threadArena = nullptr;
+}
+
+FrameArena::FrameArena(std::size_t initialCapacity, std::pmr::memory_resource* upstream)
+    : upstream(upstream)
+{
+    if (initialCapacity > 0)
+    {
+        addBlock(initialCapacity);
+    }
+}
+
+FrameArena::~FrameArena()
+{
+    releaseBlocks();
+}
+
+void FrameArena::reset()
+{
+    const std::size_t used = bytesUsed();
+    lastFrameBytes.store(used, std::memory_order_relaxed);
+    highWaterBytes.store(std::max(highWaterBytes.load(std::memory_order_relaxed), used), std::memory_order_relaxed);
+
+    // One block big enough for everything the frame needed, the next frame like it stays in there
+    if (blocks.size() > 1)
+    {
+        std::size_t total = 0;
+        for (const Block& block : blocks)
+        {
+            total += block.size;
+        }
+
+        releaseBlocks();
+        addBlock(total);
+    }
+
+    currentBlock = 0;
+    offset = 0;
+    usedInEarlierBlocks = 0;
+}
+
+FrameArena::Stats FrameArena::stats() const
+{
+    Stats result;
+    result.lastFrameBytes = lastFrameBytes.load(std::memory_order_relaxed);
+    result.highWaterBytes = highWaterBytes.load(std::memory_order_relaxed);
+    result.capacityBytes = capacityBytes.load(std::memory_order_relaxed);
+    result.upstreamAllocations = upstreamAllocations.load(std::memory_order_relaxed);
+
+    return result;
+}
+
+FrameArena& FrameArena::forThisThread()
+{
+    if (!threadArena)
+    {
+        auto arena = std::make_unique<FrameArena>();
+        threadArena = arena.get();
+
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> guard(shared.lock);
+        shared.arenas.push_back(std::move(arena));
+    }
+
+    const std::uint64_t currentFrame = frameCounter.load(std::memory_order_relaxed);
+    if (threadArena->frame != currentFrame)
+    {
+        threadArena->reset();
+        threadArena->frame = currentFrame;
+    }
+
+    return *threadArena;
+}
+
+FrameArena::Stats FrameArena::threadArenaStats()
+{
+    Stats total = {};
+
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> guard(shared.lock);
+    for (const std::unique_ptr<FrameArena>& arena : shared.arenas)
+    {
+        const Stats stats = arena->stats();
+        total.lastFrameBytes += stats.lastFrameBytes;
+        total.highWaterBytes += stats.highWaterBytes;
+        total.capacityBytes += stats.capacityBytes;
+        total.upstreamAllocations += stats.upstreamAllocations;
+    }
+
+    return total;
+}
+
+void* FrameArena::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    if (currentBlock < blocks.size())
+    {
+        const Block& block = blocks[currentBlock];
+        const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block.data);
+        const std::size_t start = alignUp(base + offset, alignment) - base;
+        if (start + bytes <= block.size)
+        {
+            offset = start + bytes;
+
+            return block.data + start;
+        }
+    }
+
+    return allocateFromNextBlock(bytes, alignment);
+}
+
+void* FrameArena::allocateFromNextBlock(std::size_t bytes, std::size_t alignment)
+{
+    // Blocks kept from earlier frames first, the leftover of the current one is lost for this frame
+    while (currentBlock + 1 < blocks.size())
+    {
+        usedInEarlierBlocks += offset;
+        ++currentBlock;
+        offset = 0;
+
+        const Block& block = blocks[currentBlock];
+        const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block.data);
+        const std::size_t start = alignUp(base, alignment) - base;
+        if (start + bytes <= block.size)
+        {
+            offset = start + bytes;
+
+            return block.data + start;
+        }
+    }
+
+    const std::size_t lastSize = blocks.empty() ? 0 : blocks.back().size;
+    addBlock(std::max(lastSize * 2, bytes + alignment));
+
+    usedInEarlierBlocks += blocks.size() > 1 ? offset : 0;
+    currentBlock = blocks.size() - 1;
+
+    const Block& block = blocks[currentBlock];
+    const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block.data);
+    const std::size_t start = alignUp(base, alignment) - base;
+    offset = start + bytes;
+
+    return block.data + start;
+}
+
+void FrameArena::addBlock(std::size_t size)
+{
+    blocks.push_back({ static_cast<std::byte*>(upstream->allocate(size, alignof(std::max_align_t))), size });
+    capacityBytes.fetch_add(size, std::memory_order_relaxed);
+    upstreamAllocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FrameArena::releaseBlocks()
+{
+    for (const Block& block : blocks)
+    {
+        upstream->deallocate(block.data, block.size, alignof(std::max_align_t));
+    }
+
+    blocks.clear();
+    capacityBytes.store(0, std::memory_order_relaxed);
+}
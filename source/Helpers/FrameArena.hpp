@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <vector>
+#include <memory_resource>
+
+// Bump allocator for scratch memory that only lives for one frame: neighbour lists, sort
+// buffers, batches. Allocating is a pointer bump, freeing does nothing and reset() drops
+// everything at once. It is a std::pmr::memory_resource, so STL containers can use it:
+//
+//      std::pmr::vector<Entity::Id> neighbours(&FrameArena::forThisThread());
+//
+// Every thread gets its own arena from forThisThread(), they all reset on their first use
+// after beginFrame() (called at the start of every simulation step). An arena that needed
+// more than one block during a frame merges them into one on reset, so steady state frames
+// don't touch the heap at all.
+//
+// NOTE: Nothing allocated from a thread arena may be used after the next beginFrame(), keep
+// containers on it local to the frame. Threads with a frame rhythm of their own (the render
+// thread) should own a FrameArena and reset() it themselves instead.
+class FrameArena : public std::pmr::memory_resource
+{
+    public:
+        struct Stats
+        {
+            std::size_t lastFrameBytes;      // Used during the last finished frame
+            std::size_t highWaterBytes;      // Most used during any frame
+            std::size_t capacityBytes;       // Held from the upstream resource
+            std::size_t upstreamAllocations; // Blocks allocated so far, stops growing once the frames are steady
+        };
+
+        explicit FrameArena(std::size_t initialCapacity = 256 * 1024, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+        ~FrameArena() override;
+
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        // Everything allocated so far becomes invalid
+        void reset();
+
+        // Owner thread only
+        std::size_t bytesUsed() const { return usedInEarlierBlocks + offset; }
+
+        // Safe to call from any thread
+        Stats stats() const;
+
+        // The calling thread's arena, reset if a frame started since the thread last asked for it
+        static FrameArena& forThisThread();
+
+        // Starts a new frame for every thread arena
+        static void beginFrame() { frameCounter.fetch_add(1, std::memory_order_relaxed); }
+
+        // Summed over every thread arena, highWaterBytes being the sum of their high water marks
+        static Stats threadArenaStats();
+
+    private:
+        struct Block
+        {
+            std::byte* data;
+            std::size_t size;
+        };
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* data, std::size_t bytes, std::size_t alignment) override {}
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+        void* allocateFromNextBlock(std::size_t bytes, std::size_t alignment);
+        void addBlock(std::size_t size);
+        void releaseBlocks();
+
+    private:
+        std::pmr::memory_resource* upstream;
+        std::vector<Block> blocks;
+        std::size_t currentBlock = 0;
+        std::size_t offset = 0;
+        std::size_t usedInEarlierBlocks = 0; // Used bytes of the blocks before currentBlock
+
+        std::atomic<std::size_t> lastFrameBytes{ 0 };
+        std::atomic<std::size_t> highWaterBytes{ 0 };
+        std::atomic<std::size_t> capacityBytes{ 0 };
+        std::atomic<std::size_t> upstreamAllocations{ 0 };
+
+        std::uint64_t frame = 0; // Last frame this arena was handed out in, thread arenas only
+
+        static std::atomic<std::uint64_t> frameCounter;
+};
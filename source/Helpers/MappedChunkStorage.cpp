@@ -0,0 +1,164 @@
+#include "MappedChunkStorage.hpp"
+
+#include <new>
+#include <cstdio>
+#include <cstdint>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+#endif
+
+#ifdef _WIN32
+
+MappedChunkStorage::MappedChunkStorage(std::string path)
+    : filePath(std::move(path))
+{
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    granularity = systemInfo.dwAllocationGranularity; // View offsets must be multiples of this, not just the page size
+
+    fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                             FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+}
+
+MappedChunkStorage::~MappedChunkStorage()
+{
+    for (auto& [view, mapping] : mappingHandles)
+    {
+        UnmapViewOfFile(view);
+        CloseHandle(mapping);
+    }
+
+    if (isOpen())
+    {
+        CloseHandle(fileHandle);
+    }
+}
+
+bool MappedChunkStorage::isOpen() const
+{
+    return fileHandle != INVALID_HANDLE_VALUE;
+}
+
+void* MappedChunkStorage::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    const std::uint64_t offset = mappedBytes;
+    const std::uint64_t size = roundToGranularity(bytes);
+    const std::uint64_t newSize = offset + size;
+
+    // A mapping object can't grow, every allocation gets its own one over the grown file.
+    HANDLE mapping = isOpen() ? CreateFileMappingA(fileHandle, nullptr, PAGE_READWRITE, static_cast<DWORD>(newSize >> 32),
+                                                   static_cast<DWORD>(newSize), nullptr) : nullptr;
+    if (!mapping)
+    {
+        throw std::bad_alloc();
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, static_cast<DWORD>(offset >> 32), static_cast<DWORD>(offset), size);
+    if (!view)
+    {
+        CloseHandle(mapping);
+        throw std::bad_alloc();
+    }
+
+    mappingHandles[view] = mapping;
+    mappedBytes = newSize;
+
+    return view;
+}
+
+void MappedChunkStorage::do_deallocate(void* data, std::size_t bytes, std::size_t alignment)
+{
+    auto iter = mappingHandles.find(data);
+    if (iter != mappingHandles.end())
+    {
+        UnmapViewOfFile(iter->first);
+        CloseHandle(iter->second);
+        mappingHandles.erase(iter);
+    }
+}
+
+void MappedChunkStorage::willNeed(const void* data, std::size_t bytes)
+{
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = const_cast<void*>(data);
+    range.NumberOfBytes = bytes;
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
+
+void MappedChunkStorage::adviseSequential(const void* data, std::size_t bytes)
+{
+    // No madvise equivalent, the file is opened as temporary so the cache manager already favors it
+}
+
+#else
+
+MappedChunkStorage::MappedChunkStorage(std::string path)
+    : filePath(std::move(path))
+    , granularity(static_cast<std::size_t>(sysconf(_SC_PAGESIZE)))
+{
+    fileDescriptor = open(filePath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+}
+
+MappedChunkStorage::~MappedChunkStorage()
+{
+    if (isOpen())
+    {
+        close(fileDescriptor);
+        unlink(filePath.c_str());
+    }
+}
+
+bool MappedChunkStorage::isOpen() const
+{
+    return fileDescriptor >= 0;
+}
+
+void* MappedChunkStorage::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    const std::size_t offset = mappedBytes;
+    const std::size_t size = roundToGranularity(bytes);
+
+    if (!isOpen() || ftruncate(fileDescriptor, static_cast<off_t>(offset + size)) != 0)
+    {
+        throw std::bad_alloc();
+    }
+
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, static_cast<off_t>(offset));
+    if (data == MAP_FAILED)
+    {
+        throw std::bad_alloc();
+    }
+
+    mappedBytes = offset + size;
+
+    return data;
+}
+
+void MappedChunkStorage::do_deallocate(void* data, std::size_t bytes, std::size_t alignment)
+{
+    munmap(data, roundToGranularity(bytes));
+}
+
+void MappedChunkStorage::willNeed(const void* data, std::size_t bytes)
+{
+    // madvise wants a page aligned start
+    const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(data) / granularity * granularity;
+    const std::uintptr_t end = reinterpret_cast<std::uintptr_t>(data) + bytes;
+    madvise(reinterpret_cast<void*>(start), end - start, MADV_WILLNEED);
+}
+
+void MappedChunkStorage::adviseSequential(const void* data, std::size_t bytes)
+{
+    const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(data) / granularity * granularity;
+    const std::uintptr_t end = reinterpret_cast<std::uintptr_t>(data) + bytes;
+    madvise(reinterpret_cast<void*>(start), end - start, MADV_SEQUENTIAL);
+}
+
+#endif
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "ChunkStorage.hpp"
+
+// ChunkStorage backed by a memory-mapped file, for simulations whose pools don't fit in
+// RAM. Every allocation is appended to the file and mapped on its own, the OS pages it
+// in and out as needed. Pass it to the EntityManager constructor and both the pools and
+// the entity tables live in the file, nothing else changes for the systems.
+//
+// NOTE: Space of freed allocations is not reused (the tables only free on growth, the
+// pools only on reset), the file is deleted when the storage is destroyed.
+class MappedChunkStorage : public ChunkStorage
+{
+    public:
+        explicit MappedChunkStorage(std::string filePath);
+        ~MappedChunkStorage() override;
+
+        MappedChunkStorage(const MappedChunkStorage&) = delete;
+        MappedChunkStorage& operator=(const MappedChunkStorage&) = delete;
+
+        bool isOpen() const;
+        std::size_t fileSize() const { return mappedBytes; }
+
+        void willNeed(const void* data, std::size_t bytes) override;
+        void adviseSequential(const void* data, std::size_t bytes) override;
+        bool isPaged() const override { return true; }
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* data, std::size_t bytes, std::size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+        std::size_t roundToGranularity(std::size_t bytes) const { return (bytes + granularity - 1) / granularity * granularity; }
+
+    private:
+        std::string filePath;
+        std::size_t granularity;
+        std::size_t mappedBytes = 0;
+
+        #ifdef _WIN32
+        void* fileHandle;
+        std::unordered_map<void*, void*> mappingHandles;
+        #else
+        int fileDescriptor;
+        #endif
+};
@@ -12,8 +12,23 @@
 
 #include <cstddef>
 #include <cassert>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <new>
 #include <vector>
 
+#include "ChunkStorage.hpp"
+
+/**
+ * Marks element types whose bytes can be saved and copied back into a pool
+ * with memcpy, and abandoned without running their destructor. Specialize it
+ * for components that are not trivially copyable but still hold plain data.
+ */
+template <typename T>
+struct BitwiseRestorable : std::is_trivially_copyable<T> {};
+
 /**
  * Provides a resizable, semi-contiguous pool of memory for constructing
  * objects in. Pointers into the pool will be invalided only when the pool is
@@ -27,14 +42,20 @@
 class BasePool
 {
     public:
-        explicit BasePool(std::size_t elementSize, std::size_t chunkSize = 8192)
-            : elementSize(elementSize), chunkSize(chunkSize), totalCapacity(0) 
-        {}
+        explicit BasePool(std::size_t elementSize, std::size_t chunkSize = 8192, bool restorable = false, ChunkStorage* storage = nullptr)
+            : elementSize(elementSize), chunkSize(chunkSize), totalCapacity(0), storage(storage ? storage : ChunkStorage::heap()), restorable(restorable)
+        {
+            // Checkpoints save memory in segments of roughly SegmentBytes, segments never
+            // cross a chunk boundary.
+            segmentSize = 1;
+            while (segmentSize * 2 * elementSize <= SegmentBytes && chunkSize % (segmentSize * 2) == 0)
+                segmentSize *= 2;
+        }
             
         virtual ~BasePool()
         {
             for (char* ptr : blocks)
-                delete[] ptr;
+                storage->deallocate(ptr, elementSize * chunkSize);
         }
 
         std::size_t size() const { return totalSize; }
@@ -57,7 +78,10 @@ class BasePool
         {
             while (totalCapacity < reserveSize)
             {
-                char* chunk = new char[elementSize * chunkSize];
+                char* chunk = static_cast<char*>(storage->allocate(elementSize * chunkSize));
+                if (storage->isPaged())
+                    storage->adviseSequential(chunk, elementSize * chunkSize);
+
                 blocks.push_back(chunk);
                 totalCapacity += chunkSize;
             }
@@ -75,14 +99,137 @@ class BasePool
             return blocks[n / chunkSize] + (n % chunkSize) * elementSize;
         }
 
+        /// Hint the storage that the chunk holding element n is about to be read.
+        inline void prefetch(std::size_t n) const
+        {
+            if (n < totalCapacity)
+                storage->willNeed(blocks[n / chunkSize], elementSize * chunkSize);
+        }
+
+        std::size_t elementsPerChunk() const { return chunkSize; }
+
         virtual void destroy(std::size_t n) = 0;
 
+        /// Exchange the elements at first and second, the flags tell which of the two
+        /// slots hold a constructed element.
+        virtual void swap(std::size_t first, std::size_t second, bool constructedFirst, bool constructedSecond) = 0;
+
+        /// True if the elements can be rolled back with memcpy, see BitwiseRestorable.
+        bool isRestorable() const { return restorable; }
+
+        /// Start tracking writes. Until endCheckpoint() the first touch() of a segment
+        /// saves its bytes so restoreCheckpoint() can copy them back. Chunks allocated
+        /// after this call are never saved, they did not exist at the checkpoint.
+        void beginCheckpoint()
+        {
+            checkpointActive = restorable;
+            checkpointSegments = blocks.size() * (chunkSize / segmentSize);
+            savedFlags.assign(checkpointActive ? checkpointSegments : 0, 0);
+            savedSegments.clear();
+            savedBytes.clear();
+        }
+
+        /// Must be called before element n is written while a checkpoint is active or
+        /// changes are tracked.
+        inline void touch(std::size_t n)
+        {
+            if (checkpointActive)
+            {
+                const std::size_t segment = n / segmentSize;
+                if (segment < checkpointSegments && !savedFlags[segment])
+                    saveSegment(segment);
+            }
+
+            if (changeTracking)
+                markChanged(n);
+        }
+
+        /// Start recording the elements passed to touch(), each one is listed once
+        /// in changes() until clearChanges().
+        void trackChanges() { changeTracking = true; }
+        bool tracksChanges() const { return changeTracking; }
+
+        const std::vector<std::uint32_t>& changes() const { return changedElements; }
+
+        void clearChanges()
+        {
+            for (std::uint32_t n : changedElements)
+                changedFlags[n] = 0;
+
+            changedElements.clear();
+        }
+
+        /// Copy every saved segment back. The saved bytes are kept, so the pool can
+        /// be rolled back to the same checkpoint again.
+        void restoreCheckpoint()
+        {
+            const std::size_t segmentBytes = segmentSize * elementSize;
+            for (std::size_t i = 0; i < savedSegments.size(); ++i)
+                std::memcpy(segmentData(savedSegments[i]), savedBytes.data() + i * segmentBytes, segmentBytes);
+        }
+
+        void endCheckpoint()
+        {
+            checkpointActive = false;
+            checkpointSegments = 0;
+            savedFlags.clear();
+            savedSegments.clear();
+            savedBytes.clear();
+        }
+
+        std::size_t checkpointBytes() const { return savedBytes.size(); }
+
+    private:
+        static constexpr std::size_t SegmentBytes = 16 * 1024;
+
+        char* segmentData(std::size_t segment)
+        {
+            const std::size_t first = segment * segmentSize;
+            return blocks[first / chunkSize] + (first % chunkSize) * elementSize;
+        }
+
+        void saveSegment(std::size_t segment)
+        {
+            const std::size_t segmentBytes = segmentSize * elementSize;
+            const std::size_t offset = savedBytes.size();
+
+            savedBytes.resize(offset + segmentBytes);
+            std::memcpy(savedBytes.data() + offset, segmentData(segment), segmentBytes);
+            savedSegments.push_back(segment);
+            savedFlags[segment] = 1;
+        }
+
+        void markChanged(std::size_t n)
+        {
+            if (changedFlags.size() <= n)
+                changedFlags.resize(totalCapacity, 0);
+
+            if (!changedFlags[n])
+            {
+                changedFlags[n] = 1;
+                changedElements.push_back(static_cast<std::uint32_t>(n));
+            }
+        }
+
     protected:
         std::vector<char*> blocks;
         std::size_t elementSize;
         std::size_t chunkSize;
         std::size_t totalSize = 0;
         std::size_t totalCapacity;
+        ChunkStorage* storage;
+
+    private:
+        bool restorable;
+        bool checkpointActive = false;
+        std::size_t segmentSize;
+        std::size_t checkpointSegments = 0;
+        std::vector<std::uint8_t> savedFlags;
+        std::vector<std::size_t> savedSegments;
+        std::vector<char> savedBytes;
+        bool changeTracking = false;
+        std::vector<std::uint8_t> changedFlags;
+        std::vector<std::uint32_t> changedElements;
 };
 
 /**
@@ -93,7 +240,7 @@ template <typename T, std::size_t ChunkSize = 8192>
 class Pool : public BasePool
 {
     public:
-        Pool() : BasePool(sizeof(T), ChunkSize) {}
+        explicit Pool(ChunkStorage* storage = nullptr) : BasePool(sizeof(T), ChunkSize, BitwiseRestorable<T>::value, storage) {}
         virtual ~Pool()
         {
             // Component destructors *must* be called by owner.
@@ -105,4 +252,60 @@ class Pool : public BasePool
             T* ptr = static_cast<T*>(get(n));
             ptr->~T();
         }
+
+        virtual void swap(std::size_t first, std::size_t second, bool constructedFirst, bool constructedSecond) override
+        {
+            assert(first < size() && second < size());
+            T* firstPtr = static_cast<T*>(get(first));
+            T* secondPtr = static_cast<T*>(get(second));
+
+            if (constructedFirst && constructedSecond)
+            {
+                T temp(std::move(*firstPtr));
+                firstPtr->~T();
+                new(firstPtr) T(std::move(*secondPtr));
+                secondPtr->~T();
+                new(secondPtr) T(std::move(temp));
+            }
+            else if (constructedFirst)
+            {
+                new(secondPtr) T(std::move(*firstPtr));
+                firstPtr->~T();
+            }
+            else if (constructedSecond)
+            {
+                new(firstPtr) T(std::move(*secondPtr));
+                secondPtr->~T();
+            }
+        }
+};
+
+/**
+ * Pool of plain bytes for element types only known at runtime (see
+ * RuntimeComponent.hpp). Elements are treated as POD, nothing is run on
+ * destruction and moving is a memcpy.
+ */
+class BytePool : public BasePool
+{
+    public:
+        explicit BytePool(std::size_t elementSize, ChunkStorage* storage = nullptr)
+            : BasePool(elementSize, 8192, true, storage)
+            , scratch(elementSize)
+        {}
+
+        virtual void destroy(std::size_t n) override
+        {
+            assert(n < size());
+        }
+
+        virtual void swap(std::size_t first, std::size_t second, bool constructedFirst, bool constructedSecond) override
+        {
+            assert(first < size() && second < size());
+            std::memcpy(scratch.data(), get(first), elementSize);
+            std::memcpy(get(first), get(second), elementSize);
+            std::memcpy(get(second), scratch.data(), elementSize);
+        }
+
+    private:
+        std::vector<char> scratch;
 };
@@ -0,0 +1,202 @@
+#include "TraceZones.hpp"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <unordered_set>
+#include <ostream>
+#include <algorithm>
+
+std::atomic<bool> TraceZones::enabled{ false };
+
+namespace
+{
+    struct Zone
+    {
+        std::atomic<const char*> name{ nullptr };
+        std::atomic<std::uint64_t> begin{ 0 };
+        std::atomic<std::uint64_t> end{ 0 };
+    };
+
+    // Single writer ring. The writer bumps started before touching a slot and finished after, a reader
+    // copying slots checks started afterwards to find out which ones might have been overwritten meanwhile.
+    struct ThreadRing
+    {
+        explicit ThreadRing(std::uint32_t threadId)
+            : zones(new Zone[TraceZones::ringCapacity])
+            , threadId(threadId)
+        {}
+
+        std::unique_ptr<Zone[]> zones;
+        std::atomic<std::uint64_t> started{ 0 };
+        std::atomic<std::uint64_t> finished{ 0 };
+        std::atomic<std::uint64_t> clearedBefore{ 0 };
+        std::uint32_t threadId;
+        std::string threadName; // Guarded by the registry lock
+    };
+
+    struct Registry
+    {
+        std::mutex lock;
+        std::vector<std::unique_ptr<ThreadRing>> rings; // Never shrinks, zones of finished threads stay readable
+        std::unordered_set<std::string> names;
+    };
+
+    Registry& registry()
+    {
+        static Registry instance;
+
+        return instance;
+    }
+
+    thread_local ThreadRing* currentRing = nullptr;
+
+    ThreadRing& ringOfThisThread()
+    {
+        if (!currentRing)
+        {
+            Registry& shared = registry();
+            std::lock_guard<std::mutex> guard(shared.lock);
+
+            shared.rings.push_back(std::make_unique<ThreadRing>(static_cast<std::uint32_t>(shared.rings.size() + 1)));
+            currentRing = shared.rings.back().get();
+        }
+
+        return *currentRing;
+    }
+
+    void writeEscaped(std::ostream& output, const char* text)
+    {
+        for (; *text; ++text)
+        {
+            const char c = *text;
+            if (c == '"' || c == '\\')
+            {
+                output << '\\' << c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                output << ' ';
+            }
+            else
+            {
+                output << c;
+            }
+        }
+    }
+
+    struct CopiedZone
+    {
+        const char* name;
+        std::uint64_t begin;
+        std::uint64_t end;
+    };
+}
+
+void TraceZones::setThreadName(const std::string& name)
+{
+    ThreadRing& ring = ringOfThisThread();
+
+    std::lock_guard<std::mutex> guard(registry().lock);
+    ring.threadName = name;
+}
+
+const char* TraceZones::intern(const std::string& name)
+{
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> guard(shared.lock);
+
+    return shared.names.insert(name).first->c_str();
+}
+
+std::uint64_t TraceZones::now()
+{
+    using Clock = std::chrono::steady_clock;
+    static const Clock::time_point epoch = Clock::now();
+
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - epoch).count());
+}
+
+void TraceZones::record(const char* name, std::uint64_t begin, std::uint64_t end)
+{
+    ThreadRing& ring = ringOfThisThread();
+
+    const std::uint64_t index = ring.finished.load(std::memory_order_relaxed);
+    ring.started.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    Zone& zone = ring.zones[index & (ringCapacity - 1)];
+    zone.name.store(name, std::memory_order_relaxed);
+    zone.begin.store(begin, std::memory_order_relaxed);
+    zone.end.store(end, std::memory_order_relaxed);
+
+    ring.finished.store(index + 1, std::memory_order_release);
+}
+
+void TraceZones::clear()
+{
+    // The writers carry on where they are, exports just skip what came before
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> guard(shared.lock);
+    for (const std::unique_ptr<ThreadRing>& ring : shared.rings)
+    {
+        ring->clearedBefore.store(ring->finished.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+void TraceZones::writeChromeTrace(std::ostream& output, std::uint64_t from, std::uint64_t to)
+{
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> guard(shared.lock);
+
+    const std::ios::fmtflags flags = output.flags();
+    const std::streamsize precision = output.precision();
+    output.setf(std::ios::fixed, std::ios::floatfield);
+    output.precision(3);
+
+    output << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    std::vector<CopiedZone> copied;
+    for (const std::unique_ptr<ThreadRing>& ring : shared.rings)
+    {
+        output << (first ? "" : ",") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << ring->threadId << ",\"args\":{\"name\":\"";
+        writeEscaped(output, ring->threadName.empty() ? "Thread" : ring->threadName.c_str());
+        output << "\"}}";
+        first = false;
+
+        const std::uint64_t finished = ring->finished.load(std::memory_order_acquire);
+        const std::uint64_t oldest = std::max(finished > ringCapacity ? finished - ringCapacity : 0, ring->clearedBefore.load(std::memory_order_relaxed));
+
+        copied.clear();
+        for (std::uint64_t i = oldest; i < finished; ++i)
+        {
+            const Zone& zone = ring->zones[i & (ringCapacity - 1)];
+            copied.push_back({ zone.name.load(std::memory_order_relaxed), zone.begin.load(std::memory_order_relaxed), zone.end.load(std::memory_order_relaxed) });
+        }
+
+        // Anything the writer started on since the copy began may be torn, drop those slots
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const std::uint64_t started = ring->started.load(std::memory_order_relaxed);
+        const std::uint64_t firstIntact = started > ringCapacity ? started - ringCapacity : 0;
+
+        for (std::uint64_t i = std::max(oldest, firstIntact); i < finished; ++i)
+        {
+            const CopiedZone& zone = copied[i - oldest];
+            if (!zone.name || zone.end < from || zone.begin > to)
+            {
+                continue;
+            }
+
+            output << ",{\"name\":\"";
+            writeEscaped(output, zone.name);
+            output << "\",\"cat\":\"engine\",\"ph\":\"X\",\"pid\":1,\"tid\":" << ring->threadId
+                   << ",\"ts\":" << zone.begin / 1000.0 << ",\"dur\":" << (zone.end - zone.begin) / 1000.0 << "}";
+        }
+    }
+
+    output << "]}\n";
+    output.flags(flags);
+    output.precision(precision);
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+#include <limits>
+#include <string>
+#include <iosfwd>
+
+// Scoped trace zones for seeing where a frame's time went across threads:
+//
+//      void MovementSystem::update(...)
+//      {
+//          TRACE_SCOPE("MovementSystem::update");
+//          ...
+//      }
+//
+//      TraceZones::setEnabled(true);
+//      ...
+//      std::ofstream file("Trace.json");
+//      TraceZones::writeChromeTrace(file); // Open in chrome://tracing or ui.perfetto.dev
+//
+// Every thread records into its own ring buffer, no locks and nothing shared on the
+// recording side. Rings keep the last ringCapacity zones of each thread, older ones get
+// overwritten. While disabled a zone costs one relaxed atomic load, define
+// TRACE_ZONES_DISABLED to compile them out entirely.
+//
+// NOTE: Names aren't copied, they have to live as long as the trace does. Use string
+// literals, or intern() for names built at runtime.
+class TraceZones
+{
+    public:
+        static constexpr std::size_t ringCapacity = 16384; // Per thread, a power of two
+
+        static void setEnabled(bool enable) { enabled.store(enable, std::memory_order_relaxed); }
+        static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+        // Shown as the thread's name in the trace viewer
+        static void setThreadName(const std::string& name);
+
+        // Returns a copy of name that lives until the program ends, the same pointer for equal names
+        static const char* intern(const std::string& name);
+
+        // Nanoseconds since the first call
+        static std::uint64_t now();
+
+        static void record(const char* name, std::uint64_t begin, std::uint64_t end);
+
+        // Forgets every recorded zone, the threads stay
+        static void clear();
+
+        // Chrome trace event format (also read by Perfetto). Zones overlapping [from, to] only,
+        // to cut out a single bad frame.
+        static void writeChromeTrace(std::ostream& output, std::uint64_t from = 0, std::uint64_t to = std::numeric_limits<std::uint64_t>::max());
+
+    private:
+        static std::atomic<bool> enabled;
+};
+
+// Records the time between construction and destruction under name
+class TraceZone
+{
+    public:
+        explicit TraceZone(const char* zoneName)
+            : name(TraceZones::isEnabled() ? zoneName : nullptr)
+            , begin(name ? TraceZones::now() : 0)
+        {}
+
+        ~TraceZone()
+        {
+            if (name)
+            {
+                TraceZones::record(name, begin, TraceZones::now());
+            }
+        }
+
+        TraceZone(const TraceZone&) = delete;
+        TraceZone& operator=(const TraceZone&) = delete;
+
+    private:
+        const char* name;
+        std::uint64_t begin;
+};
+
+#ifndef TRACE_ZONES_DISABLED
+    #define TRACE_ZONE_CONCAT_INNER(a, b) a##b
+    #define TRACE_ZONE_CONCAT(a, b) TRACE_ZONE_CONCAT_INNER(a, b)
+    #define TRACE_SCOPE(name) TraceZone TRACE_ZONE_CONCAT(traceZone, __LINE__)(name)
+#else
+    #define TRACE_SCOPE(name) ((void)0)
+#endif
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+#include <SFML/System/Vector2.hpp>
+
+// Spreads the 16 bits of value out to the even bits of the result.
+inline std::uint32_t MortonSpread(std::uint16_t value)
+{
+    std::uint32_t bits = value;
+    bits = (bits | (bits << 8)) & 0x00ff00ffU;
+    bits = (bits | (bits << 4)) & 0x0f0f0f0fU;
+    bits = (bits | (bits << 2)) & 0x33333333U;
+    bits = (bits | (bits << 1)) & 0x55555555U;
+
+    return bits;
+}
+
+// Z-order curve index of a 2D cell, cells close in space get close codes.
+inline std::uint32_t MortonEncode(std::uint16_t x, std::uint16_t y)
+{
+    return MortonSpread(x) | (MortonSpread(y) << 1);
+}
+
+// Morton code of a world position quantized to cells of cellSize units. The cell
+// grid is centered on the origin and clamped to 65536 cells on each axis.
+inline std::uint32_t MortonEncode(const sf::Vector2f& position, float cellSize)
+{
+    const auto quantize = [cellSize](float value)
+    {
+        const float cell = value / cellSize + 32768.0f;
+
+        return static_cast<std::uint16_t>(std::clamp(cell, 0.0f, 65535.0f));
+    };
+
+    return MortonEncode(quantize(position.x), quantize(position.y));
+}
@@ -6,6 +6,7 @@
 #include "ResourceContainers.hpp"
 #include "FileLoaders.hpp"
 #include "ResourceHandle.hpp"
+#include "Helpers/TraceZones.hpp"
 
 
 ResourceCache::ResourceCache(const uint32_t sizeInMb, IResourceContainer* resourceContainer)
@@ -145,6 +146,8 @@ void ResourceCache::FreeResourceHandle(const std::shared_ptr<ResourceHandle>& ha
 
 std::shared_ptr<ResourceHandle> ResourceCache::LoadResourceHandle(const std::string& fileName)
 {
+    TRACE_SCOPE("ResourceCache::LoadResourceHandle");
+
     // Grabs the correct file loader to load the file
     std::shared_ptr<IResourceFileLoader> fileLoader = nullptr;
     for (const auto& resourceFileLoader : resourceFileLoaders)
@@ -0,0 +1,214 @@
+#include "StateDelta.hpp"
+
+#include <bit>
+#include <cstring>
+
+#include "Helpers/BitStream.hpp"
+
+namespace
+{
+    void writeWord(BitWriter& writer, std::uint32_t oldWord, std::uint32_t newWord)
+    {
+        // The highest set bit of the XOR is implied by the leading zero count.
+        const std::uint32_t diff = oldWord ^ newWord;
+        const unsigned leadingZeros = static_cast<unsigned>(std::countl_zero(diff));
+
+        writer.write(leadingZeros, 5);
+        writer.write(diff, 31 - leadingZeros);
+    }
+
+    std::uint32_t readWord(BitReader& reader, std::uint32_t oldWord)
+    {
+        const unsigned leadingZeros = reader.read(5);
+        const std::uint32_t diff = (1U << (31 - leadingZeros)) | reader.read(31 - leadingZeros);
+
+        return oldWord ^ diff;
+    }
+
+    void resizeChannel(StateDelta::Channel& channel, std::size_t capacity)
+    {
+        channel.words.resize(capacity * channel.wordCount, 0);
+        channel.present.resize(capacity, 0);
+    }
+}
+
+StateDeltaEncoder::StateDeltaEncoder(const EntityManager& entityManager)
+    : entityManager(entityManager)
+{}
+
+void StateDeltaEncoder::encode(std::vector<std::uint8_t>& output)
+{
+    const std::size_t capacity = entityManager.capacity();
+
+    BitWriter writer(output);
+    writer.write(frameCounter++, 32);
+    writer.write(static_cast<std::uint32_t>(capacity), 32);
+    writer.write(static_cast<std::uint32_t>(channels.size()), 8);
+
+    for (StateDelta::Channel& channel : channels)
+    {
+        resizeChannel(channel, capacity);
+        scratchWords.assign(channel.wordCount, 0);
+
+        writer.write(static_cast<std::uint32_t>(channel.elementSize), 16);
+
+        const BasePool* pool = channel.family < entityManager.componentPools.size() ? entityManager.componentPools[channel.family] : nullptr;
+
+        std::size_t cursor = 0;
+        for (std::size_t index = 0; index < capacity; ++index)
+        {
+            std::uint32_t* baseline = channel.words.data() + index * channel.wordCount;
+            const bool present = pool && entityManager.entityComponentMasks[index].test(channel.family);
+
+            if (!present)
+            {
+                if (channel.present[index])
+                {
+                    writer.writeGamma(static_cast<std::uint32_t>(index - cursor + 1));
+                    writer.writeBit(true);
+
+                    std::memset(baseline, 0, channel.wordCount * sizeof(std::uint32_t));
+                    channel.present[index] = 0;
+                    cursor = index + 1;
+                }
+
+                continue;
+            }
+
+            std::memcpy(scratchWords.data(), pool->get(index), channel.elementSize);
+
+            bool changed = !channel.present[index];
+            for (std::size_t word = 0; word < channel.wordCount && !changed; ++word)
+            {
+                changed = scratchWords[word] != baseline[word];
+            }
+
+            if (!changed)
+            {
+                continue;
+            }
+
+            writer.writeGamma(static_cast<std::uint32_t>(index - cursor + 1));
+            writer.writeBit(false);
+
+            for (std::size_t word = 0; word < channel.wordCount; ++word)
+            {
+                writer.writeBit(scratchWords[word] != baseline[word]);
+            }
+
+            for (std::size_t word = 0; word < channel.wordCount; ++word)
+            {
+                if (scratchWords[word] != baseline[word])
+                {
+                    writeWord(writer, baseline[word], scratchWords[word]);
+                    baseline[word] = scratchWords[word];
+                }
+            }
+
+            channel.present[index] = 1;
+            cursor = index + 1;
+        }
+
+        // Terminating gap lands exactly on the capacity
+        writer.writeGamma(static_cast<std::uint32_t>(capacity - cursor + 1));
+    }
+
+    writer.flush();
+}
+
+void StateDeltaEncoder::resetBaseline()
+{
+    for (StateDelta::Channel& channel : channels)
+    {
+        channel.words.clear();
+        channel.present.clear();
+    }
+}
+
+bool StateDeltaDecoder::decode(const std::uint8_t* data, std::size_t size)
+{
+    BitReader reader(data, size);
+
+    const std::uint32_t frame = reader.read(32);
+    const std::size_t capacity = reader.read(32);
+    if (reader.read(8) != channels.size() || reader.failed())
+    {
+        return false;
+    }
+
+    for (StateDelta::Channel& channel : channels)
+    {
+        if (reader.read(16) != channel.elementSize)
+        {
+            return false;
+        }
+
+        resizeChannel(channel, capacity);
+
+        std::size_t cursor = 0;
+        while (true)
+        {
+            const std::size_t index = cursor + reader.readGamma() - 1;
+            if (reader.failed() || index > capacity)
+            {
+                return false;
+            }
+
+            if (index == capacity)
+            {
+                break;
+            }
+
+            std::uint32_t* baseline = channel.words.data() + index * channel.wordCount;
+            if (reader.readBit())
+            {
+                std::memset(baseline, 0, channel.wordCount * sizeof(std::uint32_t));
+                channel.present[index] = 0;
+            }
+            else
+            {
+                // The change mask comes first, so collect it before reading any word.
+                changedWords.resize(channel.wordCount);
+                for (std::size_t word = 0; word < channel.wordCount; ++word)
+                {
+                    changedWords[word] = reader.readBit();
+                }
+
+                for (std::size_t word = 0; word < channel.wordCount; ++word)
+                {
+                    if (changedWords[word])
+                    {
+                        baseline[word] = readWord(reader, baseline[word]);
+                    }
+                }
+
+                channel.present[index] = 1;
+            }
+
+            cursor = index + 1;
+        }
+    }
+
+    if (reader.failed())
+    {
+        return false;
+    }
+
+    frameNumber = frame;
+    entityCapacity = capacity;
+
+    return true;
+}
+
+const StateDelta::Channel* StateDeltaDecoder::channelFor(BaseComponent::Family family) const
+{
+    for (const StateDelta::Channel& channel : channels)
+    {
+        if (channel.family == family)
+        {
+            return &channel;
+        }
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <type_traits>
+
+#include "Entity/EntityManager.hpp"
+#include "Helpers/MemoryPool.hpp"
+
+// Delta compressed component state streams, meant for feeding a viewer or recorder
+// process from a running simulation.
+//
+// Every tracked component type is a channel. Components are compared against the
+// previous frame as 32-bit words, only changed words are written and each one is
+// sent as the XOR against its old value with the leading zero bits stripped. Small
+// changes to floats keep their sign and exponent, so most positions and velocities
+// cost a handful of bits instead of 32.
+//
+// Frame layout (bit packed, see Helpers/BitStream.hpp):
+//      frame number (32), entity capacity (32), channel count (8)
+//      per channel: element size (16), records, end gap (gamma)
+//      per record:  index gap (gamma), removed bit, [word change mask, changed words]
+// Gaps are from the index after the previous record, the channel ends with the gap that
+// lands exactly on the entity capacity.
+//
+// NOTE: Only BitwiseRestorable components can be tracked. The decoder hands back byte
+// images of the encoder's components, treat them as read only data (a vtable pointer
+// inside one belongs to the encoding process).
+
+namespace StateDelta
+{
+    // Per channel state shared by the encoder and decoder, a flat copy of the
+    // component words of the last frame for every entity index.
+    struct Channel
+    {
+        BaseComponent::Family family;
+        std::size_t elementSize;
+        std::size_t wordCount;
+        std::vector<std::uint32_t> words;
+        std::vector<std::uint8_t> present;
+    };
+
+    template <typename CompType>
+    Channel makeChannel()
+    {
+        static_assert(BitwiseRestorable<CompType>::value, "StateDelta ~ Only BitwiseRestorable components can be streamed");
+
+        Channel channel;
+        channel.family = EntityManager::componentFamily<CompType>();
+        channel.elementSize = sizeof(CompType);
+        // Round up to whole words, and to the alignment of the type so the decoder can
+        // hand out pointers straight into its word array.
+        const std::size_t wordAlignment = alignof(CompType) > sizeof(std::uint32_t) ? alignof(CompType) / sizeof(std::uint32_t) : 1;
+        const std::size_t words = (sizeof(CompType) + sizeof(std::uint32_t) - 1) / sizeof(std::uint32_t);
+        channel.wordCount = (words + wordAlignment - 1) / wordAlignment * wordAlignment;
+
+        return channel;
+    }
+}
+
+class StateDeltaEncoder
+{
+    public:
+        explicit StateDeltaEncoder(const EntityManager& entityManager);
+
+        // Channels must be tracked in the same order on the decoder side.
+        template <typename CompType>
+        void track() { channels.push_back(StateDelta::makeChannel<CompType>()); }
+
+        // Appends the changes since the previous encode() to output. The first frame,
+        // and the first one after resetBaseline(), is encoded against an empty world.
+        void encode(std::vector<std::uint8_t>& output);
+        void resetBaseline();
+
+        std::uint32_t frame() const { return frameCounter; }
+
+    private:
+        const EntityManager& entityManager;
+        std::vector<StateDelta::Channel> channels;
+        std::vector<std::uint32_t> scratchWords;
+        std::uint32_t frameCounter = 0;
+};
+
+class StateDeltaDecoder
+{
+    public:
+        template <typename CompType>
+        void track() { channels.push_back(StateDelta::makeChannel<CompType>()); }
+
+        // Applies one encoded frame, returns false if the data does not match the
+        // tracked channels or is truncated. The state is undefined after a failure
+        // until a full frame (see StateDeltaEncoder::resetBaseline()) is decoded.
+        bool decode(const std::uint8_t* data, std::size_t size);
+
+        std::uint32_t frame() const { return frameNumber; }
+        std::size_t capacity() const { return entityCapacity; }
+
+        template <typename CompType>
+        bool has(std::uint32_t index) const;
+
+        template <typename CompType>
+        const CompType* get(std::uint32_t index) const;
+
+    private:
+        const StateDelta::Channel* channelFor(BaseComponent::Family family) const;
+
+    private:
+        std::vector<StateDelta::Channel> channels;
+        std::vector<std::uint8_t> changedWords;
+        std::uint32_t frameNumber = 0;
+        std::size_t entityCapacity = 0;
+};
+
+template <typename CompType>
+bool StateDeltaDecoder::has(std::uint32_t index) const
+{
+    const StateDelta::Channel* channel = channelFor(EntityManager::componentFamily<CompType>());
+
+    return channel && index < entityCapacity && channel->present[index];
+}
+
+template <typename CompType>
+const CompType* StateDeltaDecoder::get(std::uint32_t index) const
+{
+    if (!has<CompType>(index))
+    {
+        return nullptr;
+    }
+
+    const StateDelta::Channel* channel = channelFor(EntityManager::componentFamily<CompType>());
+
+    return reinterpret_cast<const CompType*>(channel->words.data() + index * channel->wordCount);
+}
@@ -3,100 +3,165 @@
 #include "Components/Component.hpp"
 #include "Components/TransformableComponent.hpp"
 #include "Components/MovementComponent.hpp"
+#include "SystemAccess.hpp"
+#include "SystemRate.hpp"
+#include "Threading/JobSystem.hpp"
+#include "Helpers/TraceZones.hpp"
+
+namespace
+{
+    // Below this many entities splitting the loop up costs more than it saves
+    const std::size_t MinParallelMovers = 2048;
+    const std::size_t MoverGrainSize = 1024;
+}
+
+MovementSystem::MovementSystem(std::size_t steeringBuckets, sf::Time steeringBudget)
+    : steeringBuckets(steeringBuckets)
+    , steeringBudget(steeringBudget)
+{}
 
 void MovementSystem::configure(EventManager& eventManager)
 {}
 
+void MovementSystem::declareAccess(SystemAccess& access)
+{
+    access.reads<SteeringComponent>()
+          .writes<TransformableComponent, MovementComponent>();
+}
+
+void MovementSystem::declareRate(SystemRate& rate)
+{
+    rate.buckets(steeringBuckets);
+    if (steeringBudget > sf::Time::Zero)
+    {
+        rate.budget(steeringBudget);
+    }
+}
+
 void MovementSystem::update(EntityManager& entityManager, EventManager& eventManager, const sf::Time& deltaTime)
 {
-    ComponentPtr<MovementComponent> movementComp;
-    ComponentPtr<TransformableComponent> transComp;
-    for (Entity entity : entityManager.getEntitiesWithComponents(transComp, movementComp)) // TODO: Consider changing the value returned by getEntitiesWithComponents to reference
+    // Component pointers are fetched on this thread, a mutable one counts as a write for checkpoints and
+    // indexes and that bookkeeping isn't thread safe. The loop itself only does math on them.
+    const EntityManager& readOnlyManager = entityManager;
+    movers.clear();
     {
-        // First handle entities that have a steering component
-        if (entityManager.hasComponent<SteeringComponent>(entity.id()))
-        {
-            sf::Vector2f steeringForce = calculateSteering(entity, entityManager);
-            sf::Vector2f acceleration = steeringForce / movementComp->mass;
+        TRACE_SCOPE("MovementSystem::gather");
 
-            movementComp->velocity += acceleration * deltaTime.asSeconds();
+        ComponentPtr<MovementComponent> movementComp;
+        ComponentPtr<TransformableComponent> transComp;
+        for (Entity entity : entityManager.getEntitiesWithComponents(transComp, movementComp)) // TODO: Consider changing the value returned by getEntitiesWithComponents to reference
+        {
+            // Only the current bucket gets new steering
+            const SteeringComponent* steering = nullptr;
+            if (inCurrentBucket(entity.id()) && entityManager.hasComponent<SteeringComponent>(entity.id()))
+            {
+                steering = readOnlyManager.getComponent<const SteeringComponent>(entity.id()).get();
+            }
+
+            movers.push_back({ transComp.get(), movementComp.get(), steering });
         }
+    }
+
+    TRACE_SCOPE("MovementSystem::move");
 
-        // Limit all entities to their max velocity
-        if (Length(movementComp->velocity) > movementComp->maxSpeed)
+    JobSystem* jobs = getJobSystem();
+    if (!jobs || jobs->workerCount() == 0 || movers.size() < MinParallelMovers)
+    {
+        for (const Mover& mover : movers)
         {
-            movementComp->velocity = UnitVector(movementComp->velocity) * movementComp->maxSpeed;
+            move(mover, deltaTime);
         }
 
-        // Update our heading and side vectors. Only support headings that are
-        // the same as the velocity at the moment.
-        if (SquaredLength(movementComp->velocity) > 0.00000001)
+        return;
+    }
+
+    jobs->parallelFor(0, movers.size(), MoverGrainSize, [this, &deltaTime](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; ++i)
         {
-            movementComp->heading = UnitVector(movementComp->velocity);
-            movementComp->side = PerpendicularVector(movementComp->heading);
+            move(movers[i], deltaTime);
         }
+    });
+}
+
+void MovementSystem::move(const Mover& mover, const sf::Time& deltaTime) const
+{
+    MovementComponent& movement = *mover.movement;
+
+    // First handle entities that have a steering component. Its force is applied for the whole
+    // time since the bucket was last steered.
+    if (mover.steering)
+    {
+        sf::Vector2f steeringForce = calculateSteering(*mover.steering, movement, *mover.transform);
+        sf::Vector2f acceleration = steeringForce / movement.mass;
 
-        // Finally apply the movement to the entity position
-        transComp->move(movementComp->velocity * deltaTime.asSeconds());
+        movement.velocity += acceleration * bucketDeltaTime().asSeconds();
     }
+
+    // Limit all entities to their max velocity
+    if (Length(movement.velocity) > movement.maxSpeed)
+    {
+        movement.velocity = UnitVector(movement.velocity) * movement.maxSpeed;
+    }
+
+    // Update our heading and side vectors. Only support headings that are
+    // the same as the velocity at the moment.
+    if (SquaredLength(movement.velocity) > 0.00000001)
+    {
+        movement.heading = UnitVector(movement.velocity);
+        movement.side = PerpendicularVector(movement.heading);
+    }
+
+    // Finally apply the movement to the entity position
+    mover.transform->move(movement.velocity * deltaTime.asSeconds());
 }
 
-sf::Vector2f MovementSystem::calculateSteering(Entity& entity, EntityManager& entityManager)
+sf::Vector2f MovementSystem::calculateSteering(const SteeringComponent& steering, MovementComponent& movement, const TransformableComponent& transform) const
 {
     sf::Vector2f steeringForce;
 
-    ComponentPtr<SteeringComponent> steeringComp = entityManager.getComponent<SteeringComponent>(entity.id());
-    ComponentPtr<MovementComponent> movementComp = entityManager.getComponent<MovementComponent>(entity.id());
-    ComponentPtr<TransformableComponent> transComp = entityManager.getComponent<TransformableComponent>(entity.id());
-
-    if ((steeringComp->behaviorFlags & BehaviorType::Seek) == BehaviorType::Seek)
+    if ((steering.behaviorFlags & BehaviorType::Seek) == BehaviorType::Seek)
     {
-        steeringForce += seekBehavior(steeringComp, movementComp, transComp);
+        steeringForce += seekBehavior(steering, movement, transform);
     }
 
-    if ((steeringComp->behaviorFlags & BehaviorType::Flee) == BehaviorType::Flee)
+    if ((steering.behaviorFlags & BehaviorType::Flee) == BehaviorType::Flee)
     {
-        steeringForce += fleeBehavior(steeringComp, movementComp, transComp);
+        steeringForce += fleeBehavior(steering, movement, transform);
     }
 
-    if ((steeringComp->behaviorFlags & BehaviorType::Arrive) == BehaviorType::Arrive)
+    if ((steering.behaviorFlags & BehaviorType::Arrive) == BehaviorType::Arrive)
     {
-        steeringForce += arriveBehavior(steeringComp, movementComp, transComp);
+        steeringForce += arriveBehavior(steering, movement, transform);
     }
 
     return steeringForce;
 }
 
-sf::Vector2f MovementSystem::seekBehavior(const ComponentPtr<SteeringComponent>& steering,
-                                          const ComponentPtr<MovementComponent>& movement,
-                                          const ComponentPtr<TransformableComponent>& transform)
+sf::Vector2f MovementSystem::seekBehavior(const SteeringComponent& steering, const MovementComponent& movement, const TransformableComponent& transform) const
 {
-    sf::Vector2f desiredVelocity = UnitVector(steering->seekTarget - transform->getPosition()) * movement->maxSpeed;
+    sf::Vector2f desiredVelocity = UnitVector(steering.seekTarget - transform.getPosition()) * movement.maxSpeed;
 
-    return desiredVelocity - movement->velocity;
+    return desiredVelocity - movement.velocity;
 }
 
-sf::Vector2f MovementSystem::fleeBehavior(const ComponentPtr<SteeringComponent>& steering,
-                                          const ComponentPtr<MovementComponent>& movement,
-                                          const ComponentPtr<TransformableComponent>& transform)
+sf::Vector2f MovementSystem::fleeBehavior(const SteeringComponent& steering, const MovementComponent& movement, const TransformableComponent& transform) const
 {
     sf::Vector2f desiredVelocity;
 
-    const float fleeDistanceSq = std::pow(steering->fleePanicDistance, 2);
-    if (DistanceSquared(transform->getPosition(), steering->fleeTarget) <= fleeDistanceSq)
+    const float fleeDistanceSq = std::pow(steering.fleePanicDistance, 2);
+    if (DistanceSquared(transform.getPosition(), steering.fleeTarget) <= fleeDistanceSq)
     {
-        desiredVelocity = UnitVector(transform->getPosition() - steering->fleeTarget) * movement->maxSpeed;
+        desiredVelocity = UnitVector(transform.getPosition() - steering.fleeTarget) * movement.maxSpeed;
     }
 
-    return desiredVelocity - movement->velocity;
+    return desiredVelocity - movement.velocity;
 }
 
-sf::Vector2f MovementSystem::arriveBehavior(const ComponentPtr<SteeringComponent>& steering,
-                                            ComponentPtr<MovementComponent>& movement,
-                                            const ComponentPtr<TransformableComponent>& transform)
+sf::Vector2f MovementSystem::arriveBehavior(const SteeringComponent& steering, MovementComponent& movement, const TransformableComponent& transform) const
 {
     sf::Vector2f desiredVelocity = sf::Vector2f(0.0f, 0.0f);
-    sf::Vector2f toTarget = steering->arrivePosition - transform->getPosition();
+    sf::Vector2f toTarget = steering.arrivePosition - transform.getPosition();
     float distance = Length(toTarget);
 
     // FIXME: This is a hack to make it correctly stop when it is 
@@ -107,16 +172,16 @@ sf::Vector2f MovementSystem::arriveBehavior(const ComponentPtr<SteeringComponent
         // Tweak this to play around with the deceleration speeds.
         const float decelerationTweaker = 0.3f;
 
-        float speed = distance / (static_cast<float>(steering->arriveDeceleration) * decelerationTweaker);
-        speed = std::min(speed, movement->maxSpeed);
+        float speed = distance / (static_cast<float>(steering.arriveDeceleration) * decelerationTweaker);
+        speed = std::min(speed, movement.maxSpeed);
 
         desiredVelocity = toTarget * speed / distance;
     }
     else
     {
         // Here is the ugly hack
-        movement->velocity = sf::Vector2f(0.0f, 0.0f);
+        movement.velocity = sf::Vector2f(0.0f, 0.0f);
     }
 
-    return desiredVelocity - movement->velocity;
+    return desiredVelocity - movement.velocity;
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "System.hpp"
 #include "Components/Component.hpp"
 #include "Components/TransformableComponent.hpp"
@@ -9,26 +11,37 @@
 class MovementSystem : public System<MovementSystem>
 {
     public:
-        MovementSystem() = default;
+        // Movement is integrated every tick, steering can be spread over steeringBuckets ticks
+        // (see SystemRate::buckets()) or as many as it takes to stay under steeringBudget.
+        explicit MovementSystem(std::size_t steeringBuckets = 1, sf::Time steeringBudget = sf::Time::Zero);
 
         // System overrides
         void configure(EventManager& eventManager) override;
         void update(EntityManager& entityManager, EventManager& eventManager, const sf::Time& deltaTime) override;
+        void declareAccess(SystemAccess& access) override;
+        void declareRate(SystemRate& rate) override;
 
     private:
-        // Steering Functionality
-        // TODO: Refactor this a bit? The way we are passing component pointers in seems off to me.
-        sf::Vector2f calculateSteering(Entity& entity, EntityManager& entityManager);
+        // An entity's components, fetched before the loop is split up. Steering is nullptr when the
+        // entity doesn't steer this tick.
+        struct Mover
+        {
+            TransformableComponent* transform;
+            MovementComponent* movement;
+            const SteeringComponent* steering;
+        };
 
-        sf::Vector2f seekBehavior(const ComponentPtr<SteeringComponent>& steering,
-                                  const ComponentPtr<MovementComponent>& movement,
-                                  const ComponentPtr<TransformableComponent>& transform);
+        void move(const Mover& mover, const sf::Time& deltaTime) const;
 
-        sf::Vector2f fleeBehavior(const ComponentPtr<SteeringComponent>& steering,
-                                  const ComponentPtr<MovementComponent>& movement,
-                                  const ComponentPtr<TransformableComponent>& transform);
+        // Steering Functionality
+        sf::Vector2f calculateSteering(const SteeringComponent& steering, MovementComponent& movement, const TransformableComponent& transform) const;
 
-        sf::Vector2f arriveBehavior(const ComponentPtr<SteeringComponent>& steering,
-                                    ComponentPtr<MovementComponent>& movement,
-                                    const ComponentPtr<TransformableComponent>& transform);
+        sf::Vector2f seekBehavior(const SteeringComponent& steering, const MovementComponent& movement, const TransformableComponent& transform) const;
+        sf::Vector2f fleeBehavior(const SteeringComponent& steering, const MovementComponent& movement, const TransformableComponent& transform) const;
+        sf::Vector2f arriveBehavior(const SteeringComponent& steering, MovementComponent& movement, const TransformableComponent& transform) const;
+
+    private:
+        std::size_t steeringBuckets;
+        sf::Time steeringBudget;
+        std::vector<Mover> movers; // Reused every update
 };
\ No newline at end of file
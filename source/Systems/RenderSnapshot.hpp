@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/System/Vector2.hpp>
+
+namespace sf
+{
+    class Texture;
+}
+
+// Everything the render thread needs to draw one simulation tick, filled by
+// RenderSystem::capture() on the simulation thread and drawn by RenderSystem::render().
+// Nothing in here points back into the EntityManager, the simulation is free to move and
+// destroy components while the render thread is still drawing an older snapshot.
+struct RenderSnapshot
+{
+    // One draw call, neighbouring sprites with the same texture and kind of primitive. Strips, fans
+    // and quads are unrolled into lists in capture() so any two neighbours can share a batch.
+    struct Batch
+    {
+        const sf::Texture* texture;
+        sf::PrimitiveType primitive; // sf::Triangles, sf::Lines or sf::Points
+        std::uint32_t firstVertex;
+        std::uint32_t vertexCount;
+    };
+
+    // Keeps the clears cheap, the vectors hold on to their capacity between ticks
+    void clear()
+    {
+        batches.clear();
+        vertices.clear();
+        textures.clear();
+        debugLines.clear();
+        debugMarkers.clear();
+    }
+
+    std::uint64_t tick = 0;
+
+    std::vector<Batch> batches;
+    std::vector<sf::Vertex> vertices; // Sprite geometry copied out of the RenderableComponents, in world space
+
+    // Owners of every texture in batches, so a texture outlives its component until the snapshot is reused.
+    // Sprites sharing a texture are captured next to each other, so this is usually about as short as batches.
+    std::vector<std::shared_ptr<const sf::Texture>> textures;
+
+    // Debug draw, only filled in debug builds
+    std::vector<sf::Vertex> debugLines; // Pairs of points, drawn as sf::Lines
+    std::vector<sf::Vector2f> debugMarkers;
+};
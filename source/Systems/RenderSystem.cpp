@@ -4,10 +4,105 @@
 #include "Entity/EntityManager.hpp"
 #include "Components/Component.hpp"
 #include "Components/RenderableComponent.hpp"
+#include "Components/SharedComponent.hpp"
 #include "Components/TransformableComponent.hpp"
 #include "Components/SteeringComponent.hpp"
+#include "SystemAccess.hpp"
+#include "RenderSnapshot.hpp"
+#include "Helpers/TraceZones.hpp"
 #include "SFML/Graphics/Color.hpp"
 #include "SFML/Graphics/RenderStates.hpp"
+#include "SFML/Graphics/VertexArray.hpp"
+
+namespace
+{
+    // The list primitive a primitive's vertices are unrolled into, lists of the same kind can be concatenated
+    sf::PrimitiveType listPrimitive(sf::PrimitiveType primitive)
+    {
+        switch (primitive)
+        {
+            case sf::Points:    return sf::Points;
+            case sf::Lines:
+            case sf::LineStrip: return sf::Lines;
+            default:            return sf::Triangles;
+        }
+    }
+
+    void appendVertex(std::vector<sf::Vertex>& output, const sf::Transform& transform, const sf::Vertex& vertex)
+    {
+        output.push_back(vertex);
+        output.back().position = transform.transformPoint(vertex.position);
+    }
+
+    // Copies the vertices into output in world space, as the list primitive listPrimitive() picks
+    void appendAsList(std::vector<sf::Vertex>& output, const sf::Transform& transform, const sf::VertexArray& source)
+    {
+        const std::size_t count = source.getVertexCount();
+        switch (source.getPrimitiveType())
+        {
+            case sf::LineStrip:
+            {
+                for (std::size_t i = 1; i < count; ++i)
+                {
+                    appendVertex(output, transform, source[i - 1]);
+                    appendVertex(output, transform, source[i]);
+                }
+
+                break;
+            }
+
+            case sf::TriangleStrip:
+            {
+                // Every other triangle flips its first two vertices to keep the winding
+                for (std::size_t i = 2; i < count; ++i)
+                {
+                    appendVertex(output, transform, source[i % 2 == 0 ? i - 2 : i - 1]);
+                    appendVertex(output, transform, source[i % 2 == 0 ? i - 1 : i - 2]);
+                    appendVertex(output, transform, source[i]);
+                }
+
+                break;
+            }
+
+            case sf::TriangleFan:
+            {
+                for (std::size_t i = 2; i < count; ++i)
+                {
+                    appendVertex(output, transform, source[0]);
+                    appendVertex(output, transform, source[i - 1]);
+                    appendVertex(output, transform, source[i]);
+                }
+
+                break;
+            }
+
+            case sf::Quads:
+            {
+                for (std::size_t i = 0; i + 3 < count; i += 4)
+                {
+                    appendVertex(output, transform, source[i]);
+                    appendVertex(output, transform, source[i + 1]);
+                    appendVertex(output, transform, source[i + 2]);
+                    appendVertex(output, transform, source[i]);
+                    appendVertex(output, transform, source[i + 2]);
+                    appendVertex(output, transform, source[i + 3]);
+                }
+
+                break;
+            }
+
+            default:
+            {
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    appendVertex(output, transform, source[i]);
+                }
+
+                break;
+            }
+        }
+    }
+}
 
 RenderSystem::RenderSystem(sf::RenderTarget& target)
     : renderTarget(target)
@@ -25,61 +120,119 @@ void RenderSystem::update(EntityManager& entityManager, EventManager& eventManag
     // Not needed for now.
 }
 
-void RenderSystem::render(EntityManager& entityManager)
+void RenderSystem::declareAccess(SystemAccess& access)
+{
+    // update() doesn't touch anything yet, capture() and render() run outside of the system updates
+    access.reads<TransformableComponent, RenderableComponent>();
+}
+
+void RenderSystem::capture(EntityManager& entityManager, RenderSnapshot& snapshot)
 {
-    ComponentPtr<RenderableComponent> renderComp;
-    ComponentPtr<TransformableComponent> transComp;
-    for (const Entity& entity : entityManager.getEntitiesWithComponents(renderComp, transComp))
+    TRACE_SCOPE("RenderSystem::capture");
+
+    snapshot.clear();
+
+    // Read through the const interface, capturing must not count as a write for checkpoints and indexes
+    const EntityManager& readOnlyManager = entityManager;
+    for (Entity::Id id : entityManager.getEntityIdsWithComponents<RenderableComponent, TransformableComponent>())
     {
-        sf::RenderStates states = sf::RenderStates::Default;
+        const auto transComp = readOnlyManager.getComponent<const TransformableComponent>(id);
+        const auto renderComp = readOnlyManager.getComponent<const RenderableComponent>(id);
+        addSprite(snapshot, transComp->getTransform(), *renderComp.get());
+    }
 
-        states.transform *= transComp->getTransform();
-        states.texture = &renderComp->texture;
-        renderTarget.draw(renderComp->vertexArray, states);
+    // Shared renderables come out grouped by value, every group ends up in a single batch
+    for (const SharedComponentGroup<RenderableComponent>& group : entityManager.getEntitiesGroupedBy<RenderableComponent, TransformableComponent>())
+    {
+        for (Entity::Id id : group)
+        {
+            addSprite(snapshot, readOnlyManager.getComponent<const TransformableComponent>(id)->getTransform(), *group.value);
+        }
     }
 
     // Debug information
     #ifndef NDEBUG
     if (debugDraw)
     {
-        ComponentPtr<SteeringComponent> steeringComp;
-        for (const Entity& entity : entityManager.getEntitiesWithComponents(renderComp, transComp, steeringComp))
+        for (Entity::Id id : entityManager.getEntityIdsWithComponents<RenderableComponent, TransformableComponent, SteeringComponent>())
         {
+            const auto transComp = readOnlyManager.getComponent<const TransformableComponent>(id);
+            const auto steeringComp = readOnlyManager.getComponent<const SteeringComponent>(id);
+
             if ((steeringComp->behaviorFlags & BehaviorType::Seek) == BehaviorType::Seek)
             {
-                sf::Vertex line[] = { sf::Vertex(transComp->getPosition(), sf::Color::Red), sf::Vertex(steeringComp->seekTarget, sf::Color::Red) };
-                renderTarget.draw(line, 2, sf::Lines);
+                snapshot.debugLines.emplace_back(transComp->getPosition(), sf::Color::Red);
+                snapshot.debugLines.emplace_back(steeringComp->seekTarget, sf::Color::Red);
             }
 
             if ((steeringComp->behaviorFlags & BehaviorType::Flee) == BehaviorType::Flee)
             {
-                sf::Color drawColor;
-                if ((transComp->getPosition().x - steeringComp->fleeTarget.x) > steeringComp->fleePanicDistance &&
-                    ((transComp->getPosition().y - steeringComp->fleeTarget.y) > steeringComp->fleePanicDistance))
-                {
-                    drawColor = sf::Color::Green;
-                }
-                else
-                {
-                    drawColor = sf::Color::Red;
-                }
-
-                sf::Vertex line[] = { sf::Vertex(transComp->getPosition(), sf::Color::Red), sf::Vertex(steeringComp->fleeTarget, sf::Color::Red) };
-                renderTarget.draw(line, 2, sf::Lines);
+                snapshot.debugLines.emplace_back(transComp->getPosition(), sf::Color::Red);
+                snapshot.debugLines.emplace_back(steeringComp->fleeTarget, sf::Color::Red);
             }
 
             if ((steeringComp->behaviorFlags & BehaviorType::Arrive) == BehaviorType::Arrive)
             {
-                sf::Vertex line[] = { sf::Vertex(transComp->getPosition(), sf::Color::Red), sf::Vertex(steeringComp->arrivePosition, sf::Color::Red) };
-                renderTarget.draw(line, 2, sf::Lines);
-
-                sf::CircleShape circle(4);
-                circle.setFillColor(sf::Color::Red);
-                circle.setPosition(steeringComp->arrivePosition);
-                circle.setOrigin(circle.getRadius() / 2.0f, circle.getRadius() / 2.0f);
-                renderTarget.draw(circle);
+                snapshot.debugLines.emplace_back(transComp->getPosition(), sf::Color::Red);
+                snapshot.debugLines.emplace_back(steeringComp->arrivePosition, sf::Color::Red);
+                snapshot.debugMarkers.push_back(steeringComp->arrivePosition);
             }
         }
     }
     #endif
-}
\ No newline at end of file
+}
+
+void RenderSystem::render(const RenderSnapshot& snapshot)
+{
+    TRACE_SCOPE("RenderSystem::render");
+
+    // The vertices are in world space already, one draw per batch
+    sf::RenderStates states = sf::RenderStates::Default;
+    for (const RenderSnapshot::Batch& batch : snapshot.batches)
+    {
+        states.texture = batch.texture;
+        renderTarget.draw(&snapshot.vertices[batch.firstVertex], batch.vertexCount, batch.primitive, states);
+    }
+
+    if (!snapshot.debugLines.empty())
+    {
+        renderTarget.draw(snapshot.debugLines.data(), snapshot.debugLines.size(), sf::Lines);
+    }
+
+    if (!snapshot.debugMarkers.empty())
+    {
+        sf::CircleShape circle(4);
+        circle.setFillColor(sf::Color::Red);
+        circle.setOrigin(circle.getRadius() / 2.0f, circle.getRadius() / 2.0f);
+        for (const sf::Vector2f& position : snapshot.debugMarkers)
+        {
+            circle.setPosition(position);
+            renderTarget.draw(circle);
+        }
+    }
+}
+
+void RenderSystem::addSprite(RenderSnapshot& snapshot, const sf::Transform& transform, const RenderableComponent& renderable)
+{
+    const sf::VertexArray& source = renderable.vertexArray;
+    if (source.getVertexCount() == 0)
+    {
+        return;
+    }
+
+    const sf::PrimitiveType primitive = listPrimitive(source.getPrimitiveType());
+    const sf::Texture* texture = renderable.texture.get();
+    if (snapshot.batches.empty() || snapshot.batches.back().texture != texture || snapshot.batches.back().primitive != primitive)
+    {
+        snapshot.batches.push_back({ texture, primitive, static_cast<std::uint32_t>(snapshot.vertices.size()), 0 });
+    }
+
+    const std::size_t firstVertex = snapshot.vertices.size();
+    appendAsList(snapshot.vertices, transform, source);
+    snapshot.batches.back().vertexCount += static_cast<std::uint32_t>(snapshot.vertices.size() - firstVertex);
+
+    if (renderable.texture && (snapshot.textures.empty() || snapshot.textures.back() != renderable.texture))
+    {
+        snapshot.textures.push_back(renderable.texture);
+    }
+}
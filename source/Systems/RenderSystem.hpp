@@ -5,8 +5,12 @@
 namespace sf
 {
     class RenderTarget;
+    class Transform;
 }
 
+struct RenderSnapshot;
+struct RenderableComponent;
+
 class RenderSystem : public System<RenderSystem>
 {
     public:
@@ -14,8 +18,17 @@ class RenderSystem : public System<RenderSystem>
         
         void configure(EventManager& eventManager) override;
         void update(EntityManager& entityManager, EventManager& eventManager, const sf::Time& deltaTime) override;
+        void declareAccess(SystemAccess& access) override;
+
+        // Simulation side, copies what render() needs out of the components
+        void capture(EntityManager& entityManager, RenderSnapshot& snapshot);
 
-        void render(EntityManager& entityManager);
+        // Render side, never touches the EntityManager so it can run next to the simulation
+        void render(const RenderSnapshot& snapshot);
+
+    private:
+        // Appends the sprite to the last batch if it has the same texture and kind of primitive
+        static void addSprite(RenderSnapshot& snapshot, const sf::Transform& transform, const RenderableComponent& renderable);
 
     private:
         sf::RenderTarget& renderTarget;
@@ -0,0 +1,177 @@
+#include "SpatialReorderSystem.hpp"
+
+#include <algorithm>
+
+#include "Math/Morton.hpp"
+#include "Entity/EntityManager.hpp"
+#include "Components/Component.hpp"
+#include "Components/TransformableComponent.hpp"
+#include "Components/SteeringComponent.hpp"
+#include "SystemAccess.hpp"
+#include "Helpers/TraceZones.hpp"
+
+SpatialReorderSystem::SpatialReorderSystem(float cellSize, std::size_t swapsPerUpdate, std::size_t replanInterval)
+    : cellSize(cellSize)
+    , swapsPerUpdate(swapsPerUpdate)
+    , replanInterval(replanInterval)
+    , updatesSincePlan(replanInterval)
+{}
+
+void SpatialReorderSystem::configure(EventManager& eventManager)
+{}
+
+void SpatialReorderSystem::declareAccess(SystemAccess& access)
+{
+    // Swapping slots moves every component of the entities and emits EntityMovedEvent
+    access.exclusive();
+}
+
+void SpatialReorderSystem::update(EntityManager& entityManager, EventManager& eventManager, const sf::Time& deltaTime)
+{
+    if (nextSwap == plannedSwaps.size())
+    {
+        if (++updatesSincePlan < replanInterval)
+        {
+            return;
+        }
+
+        planReorder(entityManager);
+        updatesSincePlan = 0;
+    }
+
+    const std::size_t lastSwap = std::min(plannedSwaps.size(), nextSwap + swapsPerUpdate);
+    for (; nextSwap < lastSwap; ++nextSwap)
+    {
+        const auto [first, second] = plannedSwaps[nextSwap];
+
+        // Entities created or destroyed since the plan make some swaps pointless, the
+        // next plan fixes whatever ends up out of order.
+        if (first >= entityManager.capacity() || second >= entityManager.capacity())
+        {
+            continue;
+        }
+
+        const Entity::Id firstId = entityManager.createEntityId(first);
+        const Entity::Id secondId = entityManager.createEntityId(second);
+        if (entityManager.hasComponent<TransformableComponent>(firstId) &&
+            entityManager.hasComponent<TransformableComponent>(secondId))
+        {
+            trackSwap(entityManager, first, second);
+            entityManager.swapEntities(firstId, secondId);
+        }
+    }
+
+    remapPursuitTargets(entityManager);
+}
+
+void SpatialReorderSystem::trackSwap(const EntityManager& entityManager, std::uint32_t first, std::uint32_t second)
+{
+    if (movedTo.size() < entityManager.capacity())
+    {
+        movedTo.resize(entityManager.capacity(), NotSwapped);
+        movedFrom.resize(entityManager.capacity());
+        startVersion.resize(entityManager.capacity());
+    }
+
+    for (std::uint32_t slot : { first, second })
+    {
+        if (movedTo[slot] == NotSwapped)
+        {
+            movedTo[slot] = slot;
+            movedFrom[slot] = slot;
+            startVersion[slot] = entityManager.createEntityId(slot).version();
+            swappedSlots.push_back(slot);
+        }
+    }
+
+    const std::uint32_t firstOrigin = movedFrom[first];
+    const std::uint32_t secondOrigin = movedFrom[second];
+    movedTo[firstOrigin] = second;
+    movedTo[secondOrigin] = first;
+    movedFrom[first] = secondOrigin;
+    movedFrom[second] = firstOrigin;
+}
+
+void SpatialReorderSystem::remapPursuitTargets(EntityManager& entityManager)
+{
+    if (swappedSlots.empty())
+    {
+        return;
+    }
+
+    TRACE_SCOPE("SpatialReorderSystem::remapPursuitTargets");
+
+    // Every swap bumped the versions of both slots, possibly more often than EntityHandle has
+    // generation bits for. Handles are matched against the versions from before the swaps.
+    const EntityManager& constManager = entityManager;
+    for (Entity::Id id : entityManager.getEntityIdsWithComponents<SteeringComponent>())
+    {
+        const EntityHandle target = constManager.getComponent<const SteeringComponent>(id)->pursuitTarget;
+        if (target.isNull() || target.index() >= movedTo.size() || movedTo[target.index()] == NotSwapped || !target.matches(startVersion[target.index()]))
+        {
+            continue;
+        }
+
+        entityManager.getComponent<SteeringComponent>(id)->pursuitTarget = EntityHandle(entityManager.createEntityId(movedTo[target.index()]));
+    }
+
+    for (std::uint32_t slot : swappedSlots)
+    {
+        movedTo[slot] = NotSwapped;
+    }
+
+    swappedSlots.clear();
+}
+
+void SpatialReorderSystem::planReorder(EntityManager& entityManager)
+{
+    TRACE_SCOPE("SpatialReorderSystem::planReorder");
+
+    plannedSwaps.clear();
+    nextSwap = 0;
+
+    // Views walk the slots in ascending order, so slots ends up sorted.
+    mortonOrder.clear();
+    slots.clear();
+
+    // Read through the const interface, planning must not count as a write for checkpoints.
+    const EntityManager& constManager = entityManager;
+    for (Entity::Id id : entityManager.getEntityIdsWithComponents<TransformableComponent>())
+    {
+        const auto transComp = constManager.getComponent<const TransformableComponent>(id);
+        mortonOrder.emplace_back(MortonEncode(transComp->getPosition(), cellSize), id.index());
+        slots.push_back(id.index());
+    }
+
+    std::stable_sort(mortonOrder.begin(), mortonOrder.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+    // The k-th entity in Morton order goes to the k-th occupied slot. Follow the swaps
+    // on a simulated layout so each one moves at least one entity to its final slot.
+    location.resize(entityManager.capacity());
+    occupant.resize(entityManager.capacity());
+    for (std::uint32_t slot : slots)
+    {
+        location[slot] = slot;
+        occupant[slot] = slot;
+    }
+
+    for (std::size_t k = 0; k < slots.size(); ++k)
+    {
+        const std::uint32_t wanted = mortonOrder[k].second;
+        const std::uint32_t target = slots[k];
+        const std::uint32_t current = location[wanted];
+
+        if (current == target)
+        {
+            continue;
+        }
+
+        const std::uint32_t displaced = occupant[target];
+        plannedSwaps.emplace_back(target, current);
+
+        occupant[target] = wanted;
+        occupant[current] = displaced;
+        location[wanted] = target;
+        location[displaced] = current;
+    }
+}
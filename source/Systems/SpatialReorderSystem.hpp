@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+#include "System.hpp"
+
+// Optional maintenance pass that keeps entities with a TransformableComponent stored
+// in Morton (Z-order) order of their position, so entities close in space are close
+// in the component pools. The reorder is planned as a list of slot swaps which is
+// worked off a few at a time every update, then re-planned after replanInterval updates.
+//
+// NOTE: Swapped entities get new Ids, listen to EntityMovedEvent if you store them. The
+// SteeringComponent::pursuitTarget handles are pointed at the new ids by the system itself,
+// after every update's swaps.
+class SpatialReorderSystem : public System<SpatialReorderSystem>
+{
+    public:
+        explicit SpatialReorderSystem(float cellSize = 32.0f, std::size_t swapsPerUpdate = 512, std::size_t replanInterval = 60);
+
+        // System overrides
+        void configure(EventManager& eventManager) override;
+        void update(EntityManager& entityManager, EventManager& eventManager, const sf::Time& deltaTime) override;
+        void declareAccess(SystemAccess& access) override;
+
+        std::size_t pendingSwaps() const { return plannedSwaps.size() - nextSwap; }
+
+    private:
+        void planReorder(EntityManager& entityManager);
+
+        // Follows the entities through the swaps of an update, see remapPursuitTargets()
+        void trackSwap(const EntityManager& entityManager, std::uint32_t first, std::uint32_t second);
+        void remapPursuitTargets(EntityManager& entityManager);
+
+    private:
+        float cellSize;
+        std::size_t swapsPerUpdate;
+        std::size_t replanInterval;
+        std::size_t updatesSincePlan;
+
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> plannedSwaps;
+        std::size_t nextSwap = 0;
+
+        // Scratch buffers, kept around to avoid reallocating every plan
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> mortonOrder;
+        std::vector<std::uint32_t> slots;
+        std::vector<std::uint32_t> location;
+        std::vector<std::uint32_t> occupant;
+
+        // Swaps of the current update, indexed by slot. Only the slots in swappedSlots hold
+        // anything, movedTo is NotSwapped for the others.
+        static constexpr std::uint32_t NotSwapped = ~0U;
+        std::vector<std::uint32_t> movedTo; // Slot the entity that started the update here is in now
+        std::vector<std::uint32_t> movedFrom; // Slot the entity here now started the update in
+        std::vector<std::uint32_t> startVersion; // Version of the slot when the update started
+        std::vector<std::uint32_t> swappedSlots;
+};
@@ -4,7 +4,12 @@
 #include <SFML/System/Time.hpp>
 #include <cstddef>
 
+#include "Entity/Entity.hpp"
+
 class SystemManager;
+class SystemAccess;
+class SystemRate;
+class JobSystem;
 class EventManager;
 class EntityManager;
 
@@ -18,13 +23,47 @@ class BaseSystem : private sf::NonCopyable
         virtual void configure(EventManager& eventManager) = 0;
         virtual void update(EntityManager& entityManager, EventManager& eventManager, const sf::Time& deltaTime) = 0;
 
+        // Tells the SystemManager what update() touches so systems that don't conflict can run
+        // at the same time, see SystemAccess. Systems that don't declare anything run alone.
+        virtual void declareAccess(SystemAccess& access) {}
+
+        // Lets the SystemManager update the system less often or spread its work over several
+        // ticks, see SystemRate. Systems that don't declare anything are updated every tick.
+        virtual void declareRate(SystemRate& rate) {}
+
     protected:
+        // The round-robin slice of entities this update() works on, see SystemRate::buckets().
+        // Always true with a single bucket.
+        //
+        // NOTE: Slices go by entity index, an entity that gets a new Id (SpatialReorderSystem)
+        // can be skipped or worked on twice in the cycle it moved.
+        bool inCurrentBucket(Entity::Id id) const { return bucketCount == 1 || id.index() % bucketCount == currentBucket; }
+
+        std::size_t getCurrentBucket() const { return currentBucket; }
+        std::size_t getBucketCount() const { return bucketCount; }
+
+        // Time since the entities in the current bucket were last worked on, use it instead of
+        // update()'s deltaTime for them. Same as deltaTime with a single bucket.
+        const sf::Time& bucketDeltaTime() const { return bucketDelta; }
+
+        // The SystemManager's JobSystem for splitting update() itself up (JobSystem::parallelFor),
+        // nullptr without one. Jobs may only touch what the system declared.
+        JobSystem* getJobSystem() const { return jobSystem; }
+
         static Family familyCounter()
         {
             static Family familyCounter = 0;
 
             return familyCounter++;
         }
+
+    private:
+        friend class SystemManager;
+
+        std::size_t currentBucket = 0;
+        std::size_t bucketCount = 1;
+        sf::Time bucketDelta;
+        JobSystem* jobSystem = nullptr;
 };
 
 template <typename Derived>
@@ -43,4 +82,5 @@ class System : public BaseSystem
 
     private:
         friend class SystemManager;
+        friend class SystemAccess;
 };
\ No newline at end of file
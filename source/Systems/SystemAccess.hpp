@@ -0,0 +1,98 @@
+#pragma once
+
+#include <bitset>
+#include <vector>
+
+#include "System.hpp"
+#include "Entity/EntityManager.hpp"
+
+// What a system's update() reads and writes, filled in by BaseSystem::declareAccess(). Systems
+// run concurrently unless one writes a component the other reads or writes, or one of them
+// is exclusive. Conflicting systems run in the order they were added to the SystemManager,
+// runsAfter()/runsBefore() override that order and also hold between non conflicting systems.
+//
+//      void MovementSystem::declareAccess(SystemAccess& access)
+//      {
+//          access.reads<SteeringComponent>()
+//                .writes<TransformableComponent, MovementComponent>();
+//      }
+//
+// NOTE: Declared systems may only read and write the components they declared. Creating or
+// destroying entities, assigning or removing components and emitting events isn't thread
+// safe, systems doing that must be exclusive (send events through an EventChannel instead).
+// A non const ComponentPtr counts as a write for checkpoints and component indexes, declare
+// components read that way as written while either is in use.
+class SystemAccess
+{
+    public:
+        using ComponentMask = EntityManager::ComponentMask;
+
+        template <typename ... Components>
+        SystemAccess& reads()
+        {
+            declared = true;
+            (readMask.set(EntityManager::componentFamily<Components>()), ...);
+
+            return *this;
+        }
+
+        template <typename ... Components>
+        SystemAccess& writes()
+        {
+            declared = true;
+            (writeMask.set(EntityManager::componentFamily<Components>()), ...);
+
+            return *this;
+        }
+
+        // Runs alone, after every system added before it and before every system added after it
+        SystemAccess& exclusive()
+        {
+            declared = true;
+            exclusiveAccess = true;
+
+            return *this;
+        }
+
+        template <typename SystemType>
+        SystemAccess& runsAfter()
+        {
+            after.push_back(SystemType::family());
+
+            return *this;
+        }
+
+        template <typename SystemType>
+        SystemAccess& runsBefore()
+        {
+            before.push_back(SystemType::family());
+
+            return *this;
+        }
+
+        bool isExclusive() const { return !declared || exclusiveAccess; }
+
+        bool conflictsWith(const SystemAccess& other) const
+        {
+            if (isExclusive() || other.isExclusive())
+            {
+                return true;
+            }
+
+            return (writeMask & (other.readMask | other.writeMask)).any() || (other.writeMask & readMask).any();
+        }
+
+        const ComponentMask& readComponents() const { return readMask; }
+        const ComponentMask& writtenComponents() const { return writeMask; }
+
+    private:
+        friend class SystemManager;
+
+        ComponentMask readMask;
+        ComponentMask writeMask;
+        bool declared = false;
+        bool exclusiveAccess = false;
+
+        std::vector<BaseSystem::Family> after;
+        std::vector<BaseSystem::Family> before;
+};
@@ -0,0 +1,291 @@
+#include "SystemManager.hpp"
+#include "Threading/JobSystem.hpp"
+#include "Helpers/TraceZones.hpp"
+
+#include <cassert>
+#include <algorithm>
+#include <chrono>
+
+void SystemManager::configure()
+{
+    for (const AddedSystem& added : addedSystems)
+    {
+        SystemProfiler::Scope scope(profiler, added.profilerId, SystemProfiler::Phase::Configure);
+        added.system->configure(eventManager);
+    }
+
+    buildSchedule();
+    isInitialized = true;
+}
+
+void SystemManager::updateAllSystems(const sf::Time& deltaTime)
+{
+    assert(isInitialized && "Trying to call SystemManager::update before you have called SystemManager::configure().");
+
+    if (scheduleDirty)
+    {
+        buildSchedule();
+    }
+
+    TRACE_SCOPE("SystemManager::updateAllSystems");
+    SystemProfiler::Scope scope(profiler, allSystemsProfilerId, SystemProfiler::Phase::Update);
+
+    if (!jobSystem || jobSystem->workerCount() == 0 || schedule.size() < 2)
+    {
+        for (ScheduledSystem& scheduled : schedule)
+        {
+            updateScheduled(scheduled, deltaTime);
+        }
+
+        return;
+    }
+
+    // Systems start as soon as everything they depend on has finished
+    JobCounter counter;
+    for (std::size_t i = 0; i < schedule.size(); ++i)
+    {
+        waitingFor[i].store(schedule[i].predecessors, std::memory_order_relaxed);
+    }
+
+    for (std::size_t i = 0; i < schedule.size(); ++i)
+    {
+        if (schedule[i].predecessors == 0)
+        {
+            jobSystem->run(counter, [this, i, &deltaTime, &counter]() { runScheduled(i, deltaTime, counter); });
+        }
+    }
+
+    jobSystem->wait(counter);
+}
+
+std::vector<BaseSystem*> SystemManager::updateOrder()
+{
+    if (scheduleDirty)
+    {
+        buildSchedule();
+    }
+
+    std::vector<BaseSystem*> order;
+    for (const ScheduledSystem& scheduled : schedule)
+    {
+        order.push_back(scheduled.system);
+    }
+
+    return order;
+}
+
+void SystemManager::runScheduled(std::size_t index, const sf::Time& deltaTime, JobCounter& counter)
+{
+    updateScheduled(schedule[index], deltaTime);
+
+    for (std::size_t successor : schedule[index].successors)
+    {
+        if (waitingFor[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            jobSystem->run(counter, [this, successor, &deltaTime, &counter]() { runScheduled(successor, deltaTime, counter); });
+        }
+    }
+}
+
+void SystemManager::updateScheduled(ScheduledSystem& scheduled, const sf::Time& deltaTime)
+{
+    scheduled.sinceUpdate += deltaTime;
+    for (sf::Time& sinceBucket : scheduled.sinceBucketUpdate)
+    {
+        sinceBucket += deltaTime;
+    }
+
+    const sf::Time interval = scheduled.rate.updateInterval;
+    if (interval > sf::Time::Zero)
+    {
+        scheduled.intervalPhase += deltaTime;
+        if (scheduled.intervalPhase < interval)
+        {
+            return;
+        }
+
+        // Keep the phase so 20Hz on a 60Hz tick stays every third tick, but don't try to catch up on missed updates
+        scheduled.intervalPhase -= interval;
+        if (scheduled.intervalPhase >= interval)
+        {
+            scheduled.intervalPhase = sf::Time::Zero;
+        }
+    }
+
+    BaseSystem& system = *scheduled.system;
+    const std::size_t bucket = scheduled.nextBucket;
+    system.currentBucket = bucket;
+    system.bucketCount = scheduled.sinceBucketUpdate.size();
+    system.bucketDelta = scheduled.sinceBucketUpdate[bucket];
+
+    const sf::Time systemDelta = scheduled.sinceUpdate;
+    scheduled.sinceUpdate = sf::Time::Zero;
+    scheduled.sinceBucketUpdate[bucket] = sf::Time::Zero;
+    scheduled.nextBucket = (bucket + 1) % scheduled.sinceBucketUpdate.size();
+
+    const SystemProfiler::Clock::time_point start = SystemProfiler::Clock::now();
+    {
+        TRACE_SCOPE(scheduled.traceName);
+        SystemProfiler::Scope scope(profiler, scheduled.profilerId, SystemProfiler::Phase::Update);
+        system.update(entityManager, eventManager, systemDelta);
+    }
+
+    if (scheduled.rate.timeBudget > sf::Time::Zero)
+    {
+        scheduled.slowestInCycle = std::max(scheduled.slowestInCycle, SystemProfiler::Clock::now() - start);
+        if (scheduled.nextBucket == 0)
+        {
+            adjustBuckets(scheduled);
+        }
+    }
+}
+
+void SystemManager::adjustBuckets(ScheduledSystem& scheduled)
+{
+    const std::chrono::microseconds budget(scheduled.rate.timeBudget.asMicroseconds());
+    const std::size_t count = scheduled.sinceBucketUpdate.size();
+    const auto slowest = scheduled.slowestInCycle;
+    scheduled.slowestInCycle = SystemProfiler::Clock::duration::zero();
+
+    // Counts only ever double or halve so the buckets split or merge cleanly. Splitting keeps every
+    // entity's time since its last update exact, each new bucket takes over the time of the one it came from.
+    if (slowest > budget && count * 2 <= scheduled.rate.maxBuckets)
+    {
+        std::vector<sf::Time> split(count * 2);
+        for (std::size_t i = 0; i < split.size(); ++i)
+        {
+            split[i] = scheduled.sinceBucketUpdate[i % count];
+        }
+
+        scheduled.sinceBucketUpdate = std::move(split);
+    }
+    // Halving roughly doubles the cost of an update, only do it with a wide margin so it doesn't flip back and forth.
+    // NOTE: Merged buckets were last updated one old round apart, the entities of the more recent one get a deltaTime
+    // that long once. Giving them too much time is better than losing it.
+    else if (slowest * 4 < budget && count % 2 == 0 && count / 2 >= scheduled.rate.bucketCount)
+    {
+        std::vector<sf::Time> merged(count / 2);
+        for (std::size_t i = 0; i < merged.size(); ++i)
+        {
+            merged[i] = std::max(scheduled.sinceBucketUpdate[i], scheduled.sinceBucketUpdate[i + merged.size()]);
+        }
+
+        scheduled.sinceBucketUpdate = std::move(merged);
+    }
+}
+
+void SystemManager::buildSchedule()
+{
+    const std::size_t count = addedSystems.size();
+
+    std::vector<SystemAccess> access(count);
+    std::vector<SystemRate> rates(count);
+    std::unordered_map<std::size_t, std::size_t> positions; // Family to index in addedSystems
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        addedSystems[i].system->declareAccess(access[i]);
+        addedSystems[i].system->declareRate(rates[i]);
+        positions[addedSystems[i].family] = i;
+    }
+
+    // Explicit edges first, they decide the order conflicting systems run in
+    std::vector<std::vector<std::size_t>> edges(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        for (std::size_t family : access[i].after)
+        {
+            auto it = positions.find(family);
+            if (it != positions.end())
+            {
+                edges[it->second].push_back(i);
+            }
+        }
+
+        for (std::size_t family : access[i].before)
+        {
+            auto it = positions.find(family);
+            if (it != positions.end())
+            {
+                edges[i].push_back(it->second);
+            }
+        }
+    }
+
+    // Topological sort preferring the system added first, so the order is the same every run
+    std::vector<int> incoming(count, 0);
+    for (const std::vector<std::size_t>& successors : edges)
+    {
+        for (std::size_t successor : successors)
+        {
+            ++incoming[successor];
+        }
+    }
+
+    std::vector<std::size_t> order;
+    std::vector<bool> placed(count, false);
+    while (order.size() < count)
+    {
+        std::size_t next = count;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (!placed[i] && incoming[i] == 0)
+            {
+                next = i;
+                break;
+            }
+        }
+
+        assert(next != count && "SystemManager ~ runsAfter/runsBefore declarations form a cycle");
+        if (next == count)
+        {
+            break;
+        }
+
+        placed[next] = true;
+        order.push_back(next);
+        for (std::size_t successor : edges[next])
+        {
+            --incoming[successor];
+        }
+    }
+
+    // Every explicit edge and every conflict points forward in that order, so the graph stays acyclic
+    std::vector<std::size_t> rank(count, 0);
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        rank[order[i]] = i;
+    }
+
+    schedule.clear();
+    schedule.resize(order.size());
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        schedule[i].system = addedSystems[order[i]].system;
+        schedule[i].profilerId = addedSystems[order[i]].profilerId;
+        schedule[i].traceName = TraceZones::intern(profiler.name(schedule[i].profilerId) + "::update");
+        schedule[i].access = access[order[i]];
+        schedule[i].rate = rates[order[i]];
+        schedule[i].sinceBucketUpdate.assign(schedule[i].rate.bucketCount, sf::Time::Zero);
+    }
+
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        std::vector<bool> linked(order.size(), false);
+        for (std::size_t successor : edges[order[i]])
+        {
+            linked[rank[successor]] = true;
+        }
+
+        for (std::size_t j = i + 1; j < order.size(); ++j)
+        {
+            if (linked[j] || schedule[i].access.conflictsWith(schedule[j].access))
+            {
+                schedule[i].successors.push_back(j);
+                ++schedule[j].predecessors;
+            }
+        }
+    }
+
+    waitingFor.reset(new std::atomic<int>[schedule.size()]);
+    scheduleDirty = false;
+}
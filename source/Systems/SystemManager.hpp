@@ -11,18 +11,30 @@
 #include <SFML/System/Time.hpp>
 #include <unordered_map>
 #include <memory>
+#include <vector>
+#include <atomic>
+
+#include "System.hpp"
+#include "SystemAccess.hpp"
+#include "SystemRate.hpp"
+#include "SystemProfiler.hpp"
 
-class BaseSystem;
 class EventManager;
 class EntityManager;
+class JobSystem;
+class JobCounter;
 
 class SystemManager : private sf::NonCopyable
 {
     public:
-        SystemManager(EntityManager& entityManager, EventManager& eventManager)
+        // With a JobSystem updateAllSystems() runs systems that don't conflict concurrently,
+        // see BaseSystem::declareAccess(). Without one they run one after the other. Systems
+        // declaring a SystemRate are skipped on the ticks they aren't due.
+        SystemManager(EntityManager& entityManager, EventManager& eventManager, JobSystem* jobSystem = nullptr)
             : isInitialized(false)
             , entityManager(entityManager)
             , eventManager(eventManager)
+            , jobSystem(jobSystem)
         {}
 
         template <typename SystemType>
@@ -41,11 +53,65 @@ class SystemManager : private sf::NonCopyable
 
         void configure();
 
+        // Systems in an order updating them one by one respects every dependency
+        std::vector<BaseSystem*> updateOrder();
+
+        // configure() and update() of every system are timed, time render code with this
+        //
+        //      auto scope = systemManager.profileRender<RenderSystem>();
+        template <typename SystemType>
+        SystemProfiler::Scope profileRender();
+
+        SystemProfiler& getProfiler() { return profiler; }
+
+    private:
+        struct ScheduledSystem
+        {
+            BaseSystem* system;
+            std::size_t profilerId;
+            const char* traceName;
+            SystemAccess access;
+            std::vector<std::size_t> successors; // Indexes into schedule
+            int predecessors = 0;
+
+            SystemRate rate;
+            sf::Time sinceUpdate;   // Becomes the deltaTime of the next update()
+            sf::Time intervalPhase; // Time towards the next update with an interval
+            std::vector<sf::Time> sinceBucketUpdate;
+            std::size_t nextBucket = 0;
+            SystemProfiler::Clock::duration slowestInCycle{}; // For the budget, over one round of buckets
+        };
+
+        // Builds the dependency graph from the declared access and the explicit edges
+        void buildSchedule();
+        void runScheduled(std::size_t index, const sf::Time& deltaTime, JobCounter& counter);
+
+        // Updates the system if its rate says it's due
+        void updateScheduled(ScheduledSystem& scheduled, const sf::Time& deltaTime);
+        void adjustBuckets(ScheduledSystem& scheduled);
+
     private:
         bool isInitialized;
         EntityManager& entityManager;
         EventManager& eventManager;
+        JobSystem* jobSystem;
         std::unordered_map<std::size_t, std::shared_ptr<BaseSystem>> systems;
+
+        struct AddedSystem
+        {
+            std::size_t family;
+            BaseSystem* system;
+            std::size_t profilerId;
+        };
+
+        std::vector<AddedSystem> addedSystems; // In the order they were added
+
+        std::vector<ScheduledSystem> schedule; // In dependency order, rebuilding it restarts every rate
+        std::unique_ptr<std::atomic<int>[]> waitingFor; // Unfinished predecessors of each scheduled system this update
+        bool scheduleDirty = true;
+
+        SystemProfiler profiler;
+        std::size_t allSystemsProfilerId = profiler.addEntry("All systems"); // Wall time of updateAllSystems()
 };
 
 #include "SystemManager.inl"
\ No newline at end of file
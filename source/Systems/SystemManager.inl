@@ -1,6 +1,8 @@
 #pragma once
 
 #include <utility>
+#include <typeinfo>
+#include <algorithm>
 #include "System.hpp"
 #include "Entity/EntityManager.hpp"
 #include "EventManagement/EventManager.hpp"
@@ -8,7 +10,12 @@
 template <typename SystemType>
 void SystemManager::addSystem(std::shared_ptr<SystemType> system)
 {
-    systems.insert(std::make_pair(SystemType::family(), system));
+    if (systems.insert(std::make_pair(SystemType::family(), system)).second)
+    {
+        system->jobSystem = jobSystem;
+        addedSystems.push_back({ SystemType::family(), system.get(), profiler.addEntry(SystemProfiler::typeName(typeid(SystemType))) });
+        scheduleDirty = true;
+    }
 }
 
 template <typename SystemType, typename ... Args>
@@ -30,29 +37,18 @@ std::shared_ptr<SystemType> SystemManager::getSystem()
 }
 
 template <typename SystemType>
-void SystemManager::update(const sf::Time& deltaTime)
+SystemProfiler::Scope SystemManager::profileRender()
 {
-    assert(isInitialized && "Trying to call SystemManager::update before you have called SystemManager::configure().");
+    auto it = std::find_if(addedSystems.begin(), addedSystems.end(), [](const AddedSystem& added) { return added.family == SystemType::family(); });
+    assert(it != addedSystems.end());
 
-    getSystem<SystemType>().update(entityManager, eventManager, deltaTime);
+    return SystemProfiler::Scope(profiler, it->profilerId, SystemProfiler::Phase::Render);
 }
 
-inline void SystemManager::updateAllSystems(const sf::Time& deltaTime)
+template <typename SystemType>
+void SystemManager::update(const sf::Time& deltaTime)
 {
     assert(isInitialized && "Trying to call SystemManager::update before you have called SystemManager::configure().");
 
-    for (auto& pair : systems)
-    {
-        pair.second->update(entityManager, eventManager, deltaTime);
-    }
+    getSystem<SystemType>().update(entityManager, eventManager, deltaTime);
 }
-
-inline void SystemManager::configure()
-{
-    for (auto& pair : systems)
-    {
-        pair.second->configure(eventManager);
-    }
-
-    isInitialized = true;
-}
\ No newline at end of file
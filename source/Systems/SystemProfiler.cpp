@@ -0,0 +1,214 @@
+#include "SystemProfiler.hpp"
+
+#include <algorithm>
+#include <ostream>
+#include <cstdlib>
+
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+SystemProfiler::SystemProfiler(std::size_t historySize)
+    : historySize(historySize > 0 ? historySize : 1)
+{}
+
+std::size_t SystemProfiler::addEntry(std::string name)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    Entry entry;
+    entry.name = std::move(name);
+    for (History& history : entry.phases)
+    {
+        history.samples.resize(historySize, 0.0f);
+    }
+
+    entries.push_back(std::move(entry));
+
+    return entries.size() - 1;
+}
+
+void SystemProfiler::record(std::size_t id, Phase phase, Clock::duration duration)
+{
+    if (!enabled)
+    {
+        return;
+    }
+
+    const float milliseconds = std::chrono::duration<float, std::milli>(duration).count();
+
+    std::lock_guard<std::mutex> guard(lock);
+    History& history = entries[id].phases[static_cast<std::size_t>(phase)];
+    history.samples[history.next] = milliseconds;
+    history.next = (history.next + 1) % historySize;
+    history.count = std::min(history.count + 1, historySize);
+}
+
+void SystemProfiler::clear()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    for (Entry& entry : entries)
+    {
+        for (History& history : entry.phases)
+        {
+            history.next = 0;
+            history.count = 0;
+        }
+    }
+}
+
+SystemProfiler::Stats SystemProfiler::stats(std::size_t id, Phase phase) const
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    return computeStats(historyOf(id, phase));
+}
+
+std::vector<float> SystemProfiler::history(std::size_t id, Phase phase) const
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    return ordered(historyOf(id, phase));
+}
+
+void SystemProfiler::writeCsv(std::ostream& output) const
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    output << "system,phase,samples,last_ms,min_ms,avg_ms,p99_ms,max_ms\n";
+    for (const Entry& entry : entries)
+    {
+        for (std::size_t phase = 0; phase < static_cast<std::size_t>(Phase::Count); ++phase)
+        {
+            if (entry.phases[phase].count == 0)
+            {
+                continue;
+            }
+
+            const Stats result = computeStats(entry.phases[phase]);
+            output << entry.name << ',' << phaseName(static_cast<Phase>(phase)) << ',' << result.samples << ','
+                   << result.last << ',' << result.min << ',' << result.avg << ',' << result.p99 << ',' << result.max << '\n';
+        }
+    }
+}
+
+void SystemProfiler::writeJson(std::ostream& output) const
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    // System names are C++ identifiers, nothing to escape
+    output << "{\"systems\":[";
+    bool firstEntry = true;
+    for (const Entry& entry : entries)
+    {
+        output << (firstEntry ? "" : ",") << "{\"name\":\"" << entry.name << "\"";
+        firstEntry = false;
+
+        for (std::size_t phase = 0; phase < static_cast<std::size_t>(Phase::Count); ++phase)
+        {
+            const History& history = entry.phases[phase];
+            if (history.count == 0)
+            {
+                continue;
+            }
+
+            const Stats result = computeStats(history);
+            output << ",\"" << phaseName(static_cast<Phase>(phase)) << "\":{"
+                   << "\"samples\":" << result.samples
+                   << ",\"last\":" << result.last
+                   << ",\"min\":" << result.min
+                   << ",\"avg\":" << result.avg
+                   << ",\"p99\":" << result.p99
+                   << ",\"max\":" << result.max
+                   << ",\"history\":[";
+
+            const std::vector<float> samples = ordered(history);
+            for (std::size_t i = 0; i < samples.size(); ++i)
+            {
+                output << (i > 0 ? "," : "") << samples[i];
+            }
+
+            output << "]}";
+        }
+
+        output << "}";
+    }
+
+    output << "]}\n";
+}
+
+const char* SystemProfiler::phaseName(Phase phase)
+{
+    switch (phase)
+    {
+        case Phase::Configure: return "configure";
+        case Phase::Update:    return "update";
+        case Phase::Render:    return "render";
+        default:               return "unknown";
+    }
+}
+
+std::string SystemProfiler::typeName(const std::type_info& type)
+{
+#ifdef __GNUG__
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+    std::string name = status == 0 && demangled ? demangled : type.name();
+    std::free(demangled);
+#else
+    std::string name = type.name();
+#endif
+
+    for (const char* prefix : { "class ", "struct " })
+    {
+        const std::string tag(prefix);
+        if (name.compare(0, tag.size(), tag) == 0)
+        {
+            name.erase(0, tag.size());
+        }
+    }
+
+    return name;
+}
+
+SystemProfiler::Stats SystemProfiler::computeStats(const History& history) const
+{
+    Stats result = {};
+    if (history.count == 0)
+    {
+        return result;
+    }
+
+    std::vector<float> samples = ordered(history);
+    result.samples = samples.size();
+    result.last = samples.back();
+
+    double total = 0.0;
+    for (float sample : samples)
+    {
+        total += sample;
+    }
+
+    result.avg = total / static_cast<double>(samples.size());
+
+    std::sort(samples.begin(), samples.end());
+    result.min = samples.front();
+    result.max = samples.back();
+    result.p99 = samples[(samples.size() * 99 + 99) / 100 - 1]; // Nearest rank
+
+    return result;
+}
+
+std::vector<float> SystemProfiler::ordered(const History& history) const
+{
+    std::vector<float> samples;
+    samples.reserve(history.count);
+
+    const std::size_t first = (history.next + historySize - history.count) % historySize;
+    for (std::size_t i = 0; i < history.count; ++i)
+    {
+        samples.push_back(history.samples[(first + i) % historySize]);
+    }
+
+    return samples;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <iosfwd>
+#include <typeinfo>
+
+// Times the configure(), update() and render() calls of every system SystemManager owns and
+// keeps the last historySize samples of each, so the panel (drawSystemProfiler()) can show
+// which system eats the frame budget. Times are in milliseconds.
+//
+// NOTE: Recording takes a lock, it's a handful of calls per frame. Anything finer grained
+// should use a real profiler.
+class SystemProfiler
+{
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        enum class Phase : std::uint8_t
+        {
+            Configure,
+            Update,
+            Render,
+            Count
+        };
+
+        struct Stats
+        {
+            std::size_t samples;
+            double last;
+            double min;
+            double avg;
+            double p99;
+            double max;
+        };
+
+        // Measures from construction to destruction
+        class Scope
+        {
+            public:
+                Scope(SystemProfiler& profiler, std::size_t id, Phase phase)
+                    : profiler(profiler)
+                    , id(id)
+                    , phase(phase)
+                    , start(Clock::now())
+                {}
+
+                ~Scope() { profiler.record(id, phase, Clock::now() - start); }
+
+                Scope(const Scope&) = delete;
+                Scope& operator=(const Scope&) = delete;
+
+            private:
+                SystemProfiler& profiler;
+                std::size_t id;
+                Phase phase;
+                Clock::time_point start;
+        };
+
+        explicit SystemProfiler(std::size_t historySize = 300);
+
+        // Returns the id to record with
+        std::size_t addEntry(std::string name);
+
+        void record(std::size_t id, Phase phase, Clock::duration duration);
+
+        void setEnabled(bool enable) { enabled = enable; }
+        bool isEnabled() const { return enabled; }
+
+        // Drops every sample, the entries stay
+        void clear();
+
+        std::size_t size() const { return entries.size(); }
+        const std::string& name(std::size_t id) const { return entries[id].name; }
+
+        Stats stats(std::size_t id, Phase phase) const;
+
+        // Oldest sample first
+        std::vector<float> history(std::size_t id, Phase phase) const;
+
+        // One line per entry and phase with samples: name, phase and the stats
+        void writeCsv(std::ostream& output) const;
+
+        // The stats plus the whole history of every entry and phase with samples
+        void writeJson(std::ostream& output) const;
+
+        static const char* phaseName(Phase phase);
+
+        // Readable class name for the entries, without the "class " prefix or the mangling
+        static std::string typeName(const std::type_info& type);
+
+    private:
+        struct History
+        {
+            std::vector<float> samples; // Ring buffer
+            std::size_t next = 0;
+            std::size_t count = 0;
+        };
+
+        struct Entry
+        {
+            std::string name;
+            History phases[static_cast<std::size_t>(Phase::Count)];
+        };
+
+        const History& historyOf(std::size_t id, Phase phase) const { return entries[id].phases[static_cast<std::size_t>(phase)]; }
+        Stats computeStats(const History& history) const;
+        std::vector<float> ordered(const History& history) const;
+
+    private:
+        std::size_t historySize;
+        std::atomic<bool> enabled{ true };
+        mutable std::mutex lock;
+        std::vector<Entry> entries;
+};
+
+// ImGui window with the stats of every entry, the update history of the selected one and the
+// export buttons. Lives in SystemProfilerPanel.cpp, the only part of the profiler using ImGui.
+void drawSystemProfiler(const SystemProfiler& profiler, bool* open = nullptr);
@@ -0,0 +1,121 @@
+#include <imgui.h>
+
+#include <fstream>
+#include <vector>
+
+#include "SystemProfiler.hpp"
+#include "Helpers/TraceZones.hpp"
+#include "Helpers/FrameArena.hpp"
+
+namespace
+{
+    const char* const CsvExportPath = "SystemProfile.csv";
+    const char* const JsonExportPath = "SystemProfile.json";
+    const char* const TraceExportPath = "Trace.json";
+
+    // Frame budget at the fixed 60Hz update rate, for the history plot
+    const float FrameBudgetMs = 1000.0f / 60.0f;
+}
+
+void drawSystemProfiler(const SystemProfiler& profiler, bool* open)
+{
+    static int selected = 0;
+
+    if (!ImGui::Begin("System Profiler", open))
+    {
+        ImGui::End();
+        return;
+    }
+
+    if (ImGui::Button("Export CSV"))
+    {
+        std::ofstream file(CsvExportPath);
+        profiler.writeCsv(file);
+    }
+
+    ImGui::SameLine();
+    if (ImGui::Button("Export JSON"))
+    {
+        std::ofstream file(JsonExportPath);
+        profiler.writeJson(file);
+    }
+
+    // The trace holds the last TraceZones::ringCapacity zones of every thread, export right after a bad frame
+    bool tracing = TraceZones::isEnabled();
+    if (ImGui::Checkbox("Record trace", &tracing))
+    {
+        TraceZones::setEnabled(tracing);
+    }
+
+    ImGui::SameLine();
+    if (ImGui::Button("Export trace"))
+    {
+        std::ofstream file(TraceExportPath);
+        TraceZones::writeChromeTrace(file);
+    }
+
+    const FrameArena::Stats arenas = FrameArena::threadArenaStats();
+    ImGui::Text("Frame arenas: %.1f KB last frame, %.1f KB high water, %.1f KB held, %zu blocks allocated",
+                arenas.lastFrameBytes / 1024.0, arenas.highWaterBytes / 1024.0, arenas.capacityBytes / 1024.0, arenas.upstreamAllocations);
+
+    const ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit;
+    if (ImGui::BeginTable("Systems", 7, flags))
+    {
+        ImGui::TableSetupColumn("System", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("Phase");
+        ImGui::TableSetupColumn("Last ms");
+        ImGui::TableSetupColumn("Min ms");
+        ImGui::TableSetupColumn("Avg ms");
+        ImGui::TableSetupColumn("P99 ms");
+        ImGui::TableSetupColumn("Max ms");
+        ImGui::TableHeadersRow();
+
+        for (std::size_t id = 0; id < profiler.size(); ++id)
+        {
+            for (std::size_t phase = 0; phase < static_cast<std::size_t>(SystemProfiler::Phase::Count); ++phase)
+            {
+                // Configure only runs once, it would just take up a row forever
+                if (phase == static_cast<std::size_t>(SystemProfiler::Phase::Configure))
+                {
+                    continue;
+                }
+
+                const SystemProfiler::Stats stats = profiler.stats(id, static_cast<SystemProfiler::Phase>(phase));
+                if (stats.samples == 0)
+                {
+                    continue;
+                }
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::PushID(static_cast<int>(id));
+                if (ImGui::Selectable(profiler.name(id).c_str(), selected == static_cast<int>(id), ImGuiSelectableFlags_SpanAllColumns))
+                {
+                    selected = static_cast<int>(id);
+                }
+                ImGui::PopID();
+
+                ImGui::TableNextColumn(); ImGui::TextUnformatted(SystemProfiler::phaseName(static_cast<SystemProfiler::Phase>(phase)));
+                ImGui::TableNextColumn(); ImGui::Text("%.3f", stats.last);
+                ImGui::TableNextColumn(); ImGui::Text("%.3f", stats.min);
+                ImGui::TableNextColumn(); ImGui::Text("%.3f", stats.avg);
+                ImGui::TableNextColumn(); ImGui::Text("%.3f", stats.p99);
+                ImGui::TableNextColumn(); ImGui::Text("%.3f", stats.max);
+            }
+        }
+
+        ImGui::EndTable();
+    }
+
+    if (selected >= 0 && static_cast<std::size_t>(selected) < profiler.size())
+    {
+        const std::vector<float> history = profiler.history(selected, SystemProfiler::Phase::Update);
+        if (!history.empty())
+        {
+            ImGui::Text("%s update history (0 - %.1f ms)", profiler.name(selected).c_str(), FrameBudgetMs);
+            ImGui::PlotLines("##History", history.data(), static_cast<int>(history.size()), 0, nullptr, 0.0f, FrameBudgetMs, ImVec2(0.0f, 80.0f));
+        }
+    }
+
+    ImGui::End();
+}
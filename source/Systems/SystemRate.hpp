@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <SFML/System/Time.hpp>
+
+// How often SystemManager updates a system, filled in by BaseSystem::declareRate(). Systems
+// that don't declare anything are updated every tick.
+//
+//      void FarAgentSystem::declareRate(SystemRate& rate)
+//      {
+//          rate.frequency(20.0f)    // Three times less often than the 60Hz tick
+//              .buckets(4);         // And only a quarter of the agents each time
+//      }
+//
+// interval()/frequency() skip ticks, the deltaTime update() gets is the time since the system
+// last ran. buckets() splits the entities in round-robin slices, every update() works on one
+// slice (BaseSystem::inCurrentBucket()) and BaseSystem::bucketDeltaTime() is the time since that
+// slice was last worked on. budget() picks the bucket count by itself, doubling it while an
+// update() takes longer than the budget and halving it again once there's plenty of room.
+class SystemRate
+{
+    public:
+        SystemRate& interval(sf::Time time)
+        {
+            updateInterval = time;
+
+            return *this;
+        }
+
+        SystemRate& frequency(float hertz)
+        {
+            return interval(sf::seconds(1.0f / hertz));
+        }
+
+        SystemRate& buckets(std::size_t count)
+        {
+            bucketCount = count > 0 ? count : 1;
+
+            return *this;
+        }
+
+        // The bucket count set with buckets() is the least it goes down to
+        SystemRate& budget(sf::Time time, std::size_t maxBucketCount = 16)
+        {
+            timeBudget = time;
+            maxBuckets = maxBucketCount;
+
+            return *this;
+        }
+
+    private:
+        friend class SystemManager;
+
+        sf::Time updateInterval = sf::Time::Zero;
+        std::size_t bucketCount = 1;
+        sf::Time timeBudget = sf::Time::Zero;
+        std::size_t maxBuckets = 1;
+};
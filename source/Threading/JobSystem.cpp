@@ -0,0 +1,249 @@
+#include "JobSystem.hpp"
+#include "Helpers/TraceZones.hpp"
+
+#include <string>
+#include <cassert>
+
+namespace
+{
+    // Pool the current thread belongs to and its index in there
+    thread_local const JobSystem* currentSystem = nullptr;
+    thread_local int currentIndex = -1;
+
+    // Steal attempts before an idle worker goes to sleep
+    const int SpinsBeforeSleep = 64;
+}
+
+JobSystem::JobSystem(std::size_t workerThreads)
+    : ownerThread(std::this_thread::get_id())
+{
+    for (std::size_t i = 0; i <= workerThreads; ++i)
+    {
+        queues.push_back(std::make_unique<ThreadQueue>());
+    }
+
+    currentSystem = this;
+    currentIndex = 0;
+
+    for (std::size_t i = 1; i <= workerThreads; ++i)
+    {
+        workers.emplace_back(&JobSystem::workerLoop, this, static_cast<int>(i));
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepLock);
+        stopping.store(true);
+    }
+
+    wakeUp.notify_all();
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    // Nobody waited for these, still run them so the counters and captures get released
+    while (Job* job = findJob(-1))
+    {
+        execute(job);
+    }
+
+    if (currentSystem == this)
+    {
+        currentSystem = nullptr;
+        currentIndex = -1;
+    }
+}
+
+void JobSystem::wait(const JobCounter& counter)
+{
+    const int index = threadIndex();
+    while (!counter.done())
+    {
+        if (Job* job = findJob(index))
+        {
+            execute(job);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    // The job finishing the counter may still be holding on to it
+    std::lock_guard<std::mutex> lock(counter.continuationLock);
+}
+
+void JobSystem::adoptCallingThread()
+{
+    assert(queues[0]->jobs.size() == 0 && "JobSystem ~ The previous owner thread still has jobs queued");
+
+    ownerThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    currentSystem = this;
+    currentIndex = 0;
+}
+
+int JobSystem::threadIndex() const
+{
+    if (currentSystem != this)
+    {
+        return -1;
+    }
+
+    // A thread that handed index 0 over still has it in its thread locals
+    if (currentIndex == 0 && ownerThread.load(std::memory_order_relaxed) != std::this_thread::get_id())
+    {
+        return -1;
+    }
+
+    return currentIndex;
+}
+
+std::size_t JobSystem::defaultWorkerCount()
+{
+    const unsigned int cores = std::thread::hardware_concurrency();
+
+    return cores > 1 ? cores - 1 : 0;
+}
+
+void JobSystem::submit(Job* job)
+{
+    // Counted before the job is visible, a worker about to sleep either sees the count or gets notified
+    queuedJobs.fetch_add(1);
+
+    const int index = threadIndex();
+    if (index < 0 || !queues[index]->jobs.push(job))
+    {
+        std::lock_guard<std::mutex> lock(sharedLock);
+        sharedJobs.push_back(job);
+        sharedSize.store(sharedJobs.size(), std::memory_order_relaxed);
+    }
+
+    if (sleepingWorkers.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(sleepLock);
+        wakeUp.notify_one();
+    }
+}
+
+void JobSystem::execute(Job* job)
+{
+    job->work();
+
+    JobCounter& counter = *job->counter;
+    delete job;
+
+    finish(counter);
+}
+
+void JobSystem::finish(JobCounter& counter)
+{
+    // Not the last job, the counter may not be touched after the decrement
+    int pending = counter.pending.load(std::memory_order_relaxed);
+    while (pending > 1)
+    {
+        if (counter.pending.compare_exchange_weak(pending, pending - 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+        {
+            return;
+        }
+    }
+
+    // Probably the last one. The lock is held until the counter is left alone for good, wait()
+    // takes it before returning so the counter can't be destroyed under us.
+    std::vector<Job*> ready;
+    {
+        std::lock_guard<std::mutex> lock(counter.continuationLock);
+        if (counter.pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            ready.swap(counter.continuations);
+        }
+    }
+
+    for (Job* job : ready)
+    {
+        submit(job);
+    }
+}
+
+Job* JobSystem::findJob(int index)
+{
+    Job* job = index >= 0 ? queues[index]->jobs.pop() : nullptr;
+
+    if (!job && sharedSize.load(std::memory_order_relaxed) > 0)
+    {
+        std::lock_guard<std::mutex> lock(sharedLock);
+        if (!sharedJobs.empty())
+        {
+            job = sharedJobs.front();
+            sharedJobs.pop_front();
+            sharedSize.store(sharedJobs.size(), std::memory_order_relaxed);
+        }
+    }
+
+    if (!job)
+    {
+        job = stealJob(index);
+    }
+
+    if (job)
+    {
+        queuedJobs.fetch_sub(1);
+    }
+
+    return job;
+}
+
+Job* JobSystem::stealJob(int index)
+{
+    // Start with the next thread so the thieves spread out over the victims
+    const std::size_t count = queues.size();
+    const std::size_t start = index >= 0 ? static_cast<std::size_t>(index) + 1 : 0;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const std::size_t victim = (start + i) % count;
+        if (static_cast<int>(victim) == index)
+        {
+            continue;
+        }
+
+        if (Job* job = queues[victim]->jobs.steal())
+        {
+            return job;
+        }
+    }
+
+    return nullptr;
+}
+
+void JobSystem::workerLoop(int index)
+{
+    currentSystem = this;
+    currentIndex = index;
+    TraceZones::setThreadName("Job worker " + std::to_string(index));
+
+    int spins = 0;
+    while (!stopping.load(std::memory_order_relaxed))
+    {
+        if (Job* job = findJob(index))
+        {
+            execute(job);
+            spins = 0;
+            continue;
+        }
+
+        if (++spins < SpinsBeforeSleep)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepLock);
+        sleepingWorkers.fetch_add(1);
+        wakeUp.wait(lock, [this]() { return stopping.load() || queuedJobs.load() > 0; });
+        sleepingWorkers.fetch_sub(1);
+        spins = 0;
+    }
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <memory>
+#include <functional>
+#include <condition_variable>
+#include <SFML/System/NonCopyable.hpp>
+
+#include "WorkStealingDeque.hpp"
+
+class JobSystem;
+struct Job;
+
+// Counts the unfinished jobs started with it. Wait on it with JobSystem::wait(), or pass it as
+// the dependency of other jobs so they only start once it reaches zero.
+//
+// NOTE: Don't start new jobs with a counter other jobs depend on once it may have hit zero, the
+// dependents could already be running. Only destroy a counter after JobSystem::wait() on it
+// returned, done() alone doesn't mean the last job let go of it.
+class JobCounter : private sf::NonCopyable
+{
+    public:
+        bool done() const { return pending.load(std::memory_order_acquire) == 0; }
+        int size() const { return pending.load(std::memory_order_relaxed); }
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<int> pending{ 0 };
+
+        // Jobs started with this counter as their dependency
+        mutable std::mutex continuationLock;
+        std::vector<Job*> continuations;
+};
+
+struct Job
+{
+    std::function<void ()> work;
+    JobCounter* counter;
+};
+
+// Engine wide pool of worker threads, one per core minus the thread creating it (usually the
+// main thread). That thread is part of the pool too: it owns a queue of its own, and wait()
+// runs jobs on it until the awaited counter reaches zero instead of blocking, so waiting never
+// idles a core. When the jobs get started and waited on by another thread (the simulation
+// thread) that one takes the slot over with adoptCallingThread().
+//
+// Every pool thread has a work stealing deque, jobs go to the deque of the thread starting
+// them and idle threads steal from the others. Threads outside the pool (the render thread,
+// loader threads) can start jobs too, those go through a shared queue.
+//
+//      JobCounter counter;
+//      jobSystem.run(counter, [&]() { buildNavMesh(); });
+//      jobSystem.parallelFor(0, entities.size(), 256, [&](std::size_t begin, std::size_t end) { ... });
+//      jobSystem.wait(counter);
+//
+// NOTE: Every job is one heap allocation (plus whatever the std::function needs for its
+// captures), freed by the thread that ran it. That's noise next to jobs of a few microseconds
+// and up, cut finer work into bigger chunks (parallelFor's grainSize) rather than more jobs.
+class JobSystem : private sf::NonCopyable
+{
+    public:
+        explicit JobSystem(std::size_t workerThreads = defaultWorkerCount());
+        ~JobSystem();
+
+        template <typename Function>
+        void run(JobCounter& counter, Function&& function);
+
+        // Starts function once dependency reaches zero
+        template <typename Function>
+        void run(JobCounter& counter, JobCounter& dependency, Function&& function);
+
+        // Runs jobs on the calling thread until counter reaches zero. Threads outside the pool
+        // help with the shared queue and the other deques.
+        void wait(const JobCounter& counter);
+
+        // Calls function(begin, end) on chunks of at most grainSize items of [begin, end) and
+        // waits for them. The calling thread takes a chunk itself.
+        template <typename Function>
+        void parallelFor(std::size_t begin, std::size_t end, std::size_t grainSize, Function&& function);
+
+        // Makes the calling thread the pool's own thread (index 0) in place of the one that had it,
+        // the previous one ends up outside the pool. Call it before the thread starts any jobs,
+        // while the previous one has none of its own queued.
+        void adoptCallingThread();
+
+        // Worker threads, the thread that created the pool not included
+        std::size_t workerCount() const { return workers.size(); }
+
+        // 0 for the creating (or adopted) thread, 1..workerCount() for the workers, -1 outside the pool
+        int threadIndex() const;
+
+        static std::size_t defaultWorkerCount();
+
+    private:
+        struct ThreadQueue
+        {
+            WorkStealingDeque<Job*> jobs;
+        };
+
+        void submit(Job* job);
+        void execute(Job* job);
+        void finish(JobCounter& counter);
+
+        // Takes a job from the own deque, the shared queue or another thread, nullptr if there is none
+        Job* findJob(int index);
+        Job* stealJob(int index);
+
+        void workerLoop(int index);
+
+    private:
+        std::vector<std::unique_ptr<ThreadQueue>> queues; // Indexed by threadIndex()
+        std::vector<std::thread> workers;
+        std::atomic<std::thread::id> ownerThread; // The thread holding index 0
+
+        // Jobs from threads outside the pool, and those that didn't fit in a full deque
+        std::mutex sharedLock;
+        std::deque<Job*> sharedJobs;
+        std::atomic<std::size_t> sharedSize{ 0 }; // Lets findJob() skip the lock
+
+        // Workers sleep when there is nothing to steal
+        std::mutex sleepLock;
+        std::condition_variable wakeUp;
+        std::atomic<std::int64_t> queuedJobs{ 0 };
+        std::atomic<int> sleepingWorkers{ 0 };
+        std::atomic<bool> stopping{ false };
+};
+
+#include "JobSystem.inl"
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <utility>
+
+template <typename Function>
+void JobSystem::run(JobCounter& counter, Function&& function)
+{
+    counter.pending.fetch_add(1, std::memory_order_relaxed);
+    submit(new Job{ std::forward<Function>(function), &counter });
+}
+
+template <typename Function>
+void JobSystem::run(JobCounter& counter, JobCounter& dependency, Function&& function)
+{
+    counter.pending.fetch_add(1, std::memory_order_relaxed);
+    Job* job = new Job{ std::forward<Function>(function), &counter };
+
+    {
+        std::lock_guard<std::mutex> lock(dependency.continuationLock);
+        if (!dependency.done())
+        {
+            dependency.continuations.push_back(job);
+            return;
+        }
+    }
+
+    submit(job);
+}
+
+template <typename Function>
+void JobSystem::parallelFor(std::size_t begin, std::size_t end, std::size_t grainSize, Function&& function)
+{
+    if (begin >= end)
+    {
+        return;
+    }
+
+    grainSize = grainSize > 0 ? grainSize : 1;
+
+    // Small ranges aren't worth the jobs
+    if (end - begin <= grainSize || workers.empty())
+    {
+        function(begin, end);
+        return;
+    }
+
+    JobCounter counter;
+    for (std::size_t chunkBegin = begin + grainSize; chunkBegin < end; chunkBegin += grainSize)
+    {
+        const std::size_t chunkEnd = end - chunkBegin > grainSize ? chunkBegin + grainSize : end;
+        run(counter, [&function, chunkBegin, chunkEnd]() { function(chunkBegin, chunkEnd); });
+    }
+
+    function(begin, begin + grainSize);
+    wait(counter);
+}
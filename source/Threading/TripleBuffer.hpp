@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+
+// Hands the latest value from one writer thread to one reader thread without either of them
+// ever waiting. The writer fills writeBuffer() and publish()es it, the reader acquire()s and
+// then reads readBuffer() for as long as it likes. Values the reader never got to are skipped,
+// it always ends up with the newest one.
+//
+// NOTE: Strictly one writer and one reader. Buffers get reused, so the writer should clear the
+// parts it refills instead of reallocating them (that's the point of keeping them around).
+template <typename T>
+class TripleBuffer
+{
+    public:
+        TripleBuffer() = default;
+
+        TripleBuffer(const TripleBuffer&) = delete;
+        TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+        // Writer only
+        T& writeBuffer() { return buffers[writeIndex]; }
+
+        // Writer only, swaps the filled buffer with the one in the middle
+        void publish()
+        {
+            writeIndex = middle.exchange(static_cast<std::uint8_t>(writeIndex | FreshBit), std::memory_order_acq_rel) & IndexMask;
+        }
+
+        // Reader only, returns true if a newer buffer than readBuffer() was published since the last call
+        bool acquire()
+        {
+            if ((middle.load(std::memory_order_relaxed) & FreshBit) == 0)
+            {
+                return false;
+            }
+
+            readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & IndexMask;
+
+            return true;
+        }
+
+        // Reader only
+        const T& readBuffer() const { return buffers[readIndex]; }
+
+    private:
+        static constexpr std::uint8_t IndexMask = 0x3;
+        static constexpr std::uint8_t FreshBit = 0x4;
+
+        T buffers[3];
+
+        // Each index is only touched by its own side, the middle is the only shared state
+        alignas(64) std::uint8_t writeIndex = 0;
+        alignas(64) std::uint8_t readIndex = 1;
+        alignas(64) std::atomic<std::uint8_t> middle{ 2 };
+};
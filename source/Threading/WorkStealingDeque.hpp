@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+
+// Fixed capacity Chase-Lev deque (Lê, Pop, Cohen, Zappa Nardelli 2013). The owning thread
+// pushes and pops at the bottom, any other thread steals from the top. T has to be a pointer
+// or another trivially copyable type that fits in an atomic, nullptr/T() means "nothing".
+//
+// NOTE: The buffer never grows, push() returns false once it's full and the caller has to deal
+// with the item itself. Growing would need the old buffers kept alive until no thief reads them.
+template <typename T>
+class WorkStealingDeque
+{
+    public:
+        // Capacity is rounded up to a power of two
+        explicit WorkStealingDeque(std::size_t requestedCapacity = 4096)
+        {
+            std::size_t capacity = 2;
+            while (capacity < requestedCapacity)
+            {
+                capacity *= 2;
+            }
+
+            buffer.reset(new std::atomic<T>[capacity]);
+            mask = static_cast<std::int64_t>(capacity - 1);
+        }
+
+        WorkStealingDeque(const WorkStealingDeque&) = delete;
+        WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+        // Owner only
+        bool push(T item)
+        {
+            const std::int64_t b = bottom.load(std::memory_order_relaxed);
+            const std::int64_t t = top.load(std::memory_order_acquire);
+            if (b - t > mask)
+            {
+                return false;
+            }
+
+            buffer[b & mask].store(item, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        // Owner only, newest item first
+        T pop()
+        {
+            const std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+            bottom.store(b, std::memory_order_seq_cst);
+            std::int64_t t = top.load(std::memory_order_seq_cst);
+
+            if (t > b)
+            {
+                // Empty
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return T();
+            }
+
+            T item = buffer[b & mask].load(std::memory_order_relaxed);
+            if (t == b)
+            {
+                // Last item, race the thieves for it
+                if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                {
+                    item = T();
+                }
+
+                bottom.store(b + 1, std::memory_order_relaxed);
+            }
+
+            return item;
+        }
+
+        // Any thread, oldest item first
+        T steal()
+        {
+            std::int64_t t = top.load(std::memory_order_seq_cst);
+            const std::int64_t b = bottom.load(std::memory_order_seq_cst);
+
+            if (t >= b)
+            {
+                return T();
+            }
+
+            T item = buffer[t & mask].load(std::memory_order_relaxed);
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                return T();
+            }
+
+            return item;
+        }
+
+        // Approximate when other threads are using the deque
+        std::size_t size() const
+        {
+            const std::int64_t b = bottom.load(std::memory_order_relaxed);
+            const std::int64_t t = top.load(std::memory_order_relaxed);
+
+            return b > t ? static_cast<std::size_t>(b - t) : 0;
+        }
+
+    private:
+        static constexpr std::size_t CacheLine = 64;
+
+        std::unique_ptr<std::atomic<T>[]> buffer;
+        std::int64_t mask;
+
+        // Thieves hammer top, the owner bottom
+        alignas(CacheLine) std::atomic<std::int64_t> top{ 0 };
+        alignas(CacheLine) std::atomic<std::int64_t> bottom{ 0 };
+};